@@ -4,9 +4,79 @@
 
 #ifndef DATASTRUCTURES_H
 #define DATASTRUCTURES_H
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <new>
 #include <stdexcept>
 
 namespace ds {
+    /**
+     * Slab allocator for objects of type N.
+     * Objects are carved out of contiguous blocks (growing 16, 32, ... up to 4096 objects per block),
+     * released objects are recycled through a free list, and all blocks are freed at once when the pool dies.
+     */
+    template<class N>
+    class SlabPool {
+        static constexpr int MIN_BLOCK = 16, MAX_BLOCK = 4096;
+
+        union Slot {
+            N obj;
+            Slot *next_free;
+
+            Slot() {
+            }
+
+            ~Slot() {
+            }
+        };
+
+        struct Block {
+            Slot *slots;
+            Block *next;
+        };
+
+        Block *blocks = nullptr;
+        Slot *free_list = nullptr;
+        int block_size = 0, used = 0;
+
+    public:
+        SlabPool() = default;
+
+        ~SlabPool() {
+            while (blocks) {
+                const auto tmp = blocks;
+                blocks = blocks->next;
+                delete[] tmp->slots;
+                delete tmp;
+            }
+        }
+
+        N *allocate() {
+            Slot *slot;
+            if (free_list) {
+                slot = free_list;
+                free_list = free_list->next_free;
+            } else {
+                if (blocks == nullptr || used == block_size) {
+                    block_size = block_size == 0 ? MIN_BLOCK : (block_size < MAX_BLOCK ? 2 * block_size : block_size);
+                    blocks = new Block{new Slot[block_size], blocks};
+                    used = 0;
+                }
+                slot = &blocks->slots[used++];
+            }
+            return new(&slot->obj) N();
+        }
+
+        void release(N *obj) {
+            obj->~N();
+            const auto slot = reinterpret_cast<Slot *>(obj);
+            slot->next_free = free_list;
+            free_list = slot;
+        }
+    };
+
     template<class T>
     class LinkedList {
         int len = 0;
@@ -19,36 +89,56 @@ namespace ds {
             Link *next = nullptr;
         };
 
+    private:
+        // when set, links come from (and return to) the pool instead of new/delete
+        SlabPool<Link<T> > *pool = nullptr;
+
+        Link<T> *newLink() {
+            return pool ? pool->allocate() : new Link<T>();
+        }
+
+        void deleteLink(Link<T> *link) {
+            if (pool) pool->release(link);
+            else delete link;
+        }
+
+    public:
         Link<T> *head = nullptr;
+        Link<T> *tail = nullptr; // kept so addLast is O(1)
 
         LinkedList() = default;
 
+        explicit LinkedList(SlabPool<Link<T> > *pool) : pool(pool) {
+        }
+
         ~LinkedList() {
             while (head) {
                 const auto tmp = head;
                 head = head->next;
-                delete tmp;
+                deleteLink(tmp);
             }
         }
 
+        void setPool(SlabPool<Link<T> > *pool) {
+            if (head) throw std::logic_error("can't change pool of a non-empty list");
+            this->pool = pool;
+        }
+
         void addFirst(const T val) {
-            const auto newNode = new Link<T>();
+            const auto newNode = newLink();
             newNode->val = val;
             if (head) newNode->next = head;
+            else tail = newNode;
             head = newNode;
             len++;
         }
 
         void addLast(const T val) {
-            const auto newNode = new Link<T>();
+            const auto newNode = newLink();
             newNode->val = val;
-            if (head == nullptr) {
-                head = newNode;
-            } else {
-                auto tail = head;
-                while (tail->next) tail = tail->next;
-                tail->next = newNode;
-            }
+            if (head == nullptr) head = newNode;
+            else tail->next = newNode;
+            tail = newNode;
             len++;
         }
 
@@ -64,7 +154,8 @@ namespace ds {
             if (head) {
                 const auto tmp = head;
                 head = head->next;
-                delete tmp;
+                if (!head) tail = nullptr;
+                deleteLink(tmp);
                 len--;
                 return true;
             }
@@ -75,24 +166,24 @@ namespace ds {
             while (head) {
                 const auto tmp = head;
                 head = head->next;
-                delete tmp;
+                deleteLink(tmp);
             }
+            tail = nullptr;
             len = 0;
         }
 
         bool deleteLast() {
             if (head) {
+                // singly linked, so finding the new tail is still a walk
                 if (head->next) {
-                    auto prev = head, tail = head->next;
-                    while (tail->next) {
-                        prev = tail;
-                        tail = tail->next;
-                    }
-                    delete tail;
+                    auto prev = head;
+                    while (prev->next != tail) prev = prev->next;
+                    deleteLink(tail);
                     prev->next = nullptr;
+                    tail = prev;
                 } else {
-                    delete head;
-                    head = nullptr;
+                    deleteLink(head);
+                    head = tail = nullptr;
                 }
                 len--;
                 return true;
@@ -101,7 +192,8 @@ namespace ds {
         }
 
         bool removeValue(const T val) {
-            if (head && head->val == val) {
+            if (!head) return false;
+            if (head->val == val) {
                 deleteFirst();
                 return true;
             }
@@ -109,7 +201,8 @@ namespace ds {
             while (node) {
                 if (node->val == val) {
                     prev->next = node->next;
-                    delete node;
+                    if (node == tail) tail = prev;
+                    deleteLink(node);
                     len--;
                     return true;
                 }
@@ -213,6 +306,116 @@ namespace ds {
         void clear() { list->clear(); }
     };
 
+    /**
+     * Fixed capacity FIFO queue over a circular array. No per-element allocation.
+     */
+    template<class T>
+    class RingQueue {
+        T *buffer;
+        int capacity, first = 0, len = 0;
+
+    public:
+        RingQueue(const int capacity) : capacity(capacity) {
+            buffer = new T[capacity > 0 ? capacity : 1];
+        }
+
+        ~RingQueue() {
+            delete[] buffer;
+        }
+
+        void insert(const T val) {
+            if (len == capacity) throw std::out_of_range("Queue is full");
+            buffer[(first + len++) % capacity] = val;
+        }
+
+        T peek() const {
+            if (len == 0) throw std::out_of_range("Queue is empty");
+            return buffer[first];
+        }
+
+        T pop() {
+            const auto val = peek();
+            first = (first + 1) % capacity;
+            len--;
+            return val;
+        }
+
+        bool isEmpty() const { return len == 0; }
+
+        int size() const { return len; }
+
+        void clear() { first = len = 0; }
+    };
+
+    /**
+     * Growable array (doubling), for buffers whose size isn't known up front.
+     */
+    template<class T>
+    class ArrayList {
+        T *items;
+        int capacity, len = 0;
+
+    public:
+        ArrayList(const int capacity = 16) : capacity(capacity > 0 ? capacity : 1) {
+            items = new T[this->capacity];
+        }
+
+        ~ArrayList() {
+            delete[] items;
+        }
+
+        void add(const T val) {
+            if (len == capacity) {
+                const auto bigger = new T[2 * capacity];
+                for (int i = 0; i < len; i++) bigger[i] = items[i];
+                delete[] items;
+                items = bigger;
+                capacity *= 2;
+            }
+            items[len++] = val;
+        }
+
+        T &operator[](const int i) { return items[i]; }
+
+        const T &operator[](const int i) const { return items[i]; }
+
+        void pop() { len--; }
+
+        int size() const { return len; }
+
+        bool isEmpty() const { return len == 0; }
+
+        void clear() { len = 0; }
+    };
+
+    /**
+     * Dense set of ids 0..n-1, one bit per id.
+     */
+    class Bitmap {
+        static constexpr int WORD = 64;
+        unsigned long long *words;
+        int n_words;
+
+    public:
+        Bitmap(const int n) : n_words((n + WORD - 1) / WORD) {
+            words = new unsigned long long[n_words > 0 ? n_words : 1]();
+        }
+
+        ~Bitmap() {
+            delete[] words;
+        }
+
+        bool get(const int i) const { return words[i / WORD] >> (i % WORD) & 1; }
+
+        void set(const int i) { words[i / WORD] |= 1ULL << (i % WORD); }
+
+        void unset(const int i) { words[i / WORD] &= ~(1ULL << (i % WORD)); }
+
+        void clear() {
+            for (int i = 0; i < n_words; i++) words[i] = 0;
+        }
+    };
+
     class UnionSet {
         int *parent, *rank;
 
@@ -231,8 +434,16 @@ namespace ds {
             delete[] rank;
         }
 
-        int find(const int i) {
-            return (parent[i] == i) ? i : (parent[i] = find(parent[i]));
+        int find(int i) {
+            // iterative, no recursion depth on long chains: find the root, then point the path at it
+            int root = i;
+            while (parent[root] != root) root = parent[root];
+            while (parent[i] != root) {
+                const int next = parent[i];
+                parent[i] = root;
+                i = next;
+            }
+            return root;
         }
 
         void unite(const int x, const int y) {
@@ -245,6 +456,400 @@ namespace ds {
         }
     };
 
+    /**
+     * Binary min-heap over ids 0..n-1 with an id -> heap position map,
+     * supporting O(log n) insert, popMin and decreaseKey, and O(1) contains.
+     */
+    class IndexedMinHeap {
+        int *heap, *pos, *key;
+        int len = 0;
+
+        void swap(const int i, const int j) {
+            const int tmp = heap[i];
+            heap[i] = heap[j];
+            heap[j] = tmp;
+            pos[heap[i]] = i;
+            pos[heap[j]] = j;
+        }
+
+        void siftUp(int i) {
+            while (i > 0 && key[heap[i]] < key[heap[(i - 1) / 2]]) {
+                swap(i, (i - 1) / 2);
+                i = (i - 1) / 2;
+            }
+        }
+
+        void siftDown(int i) {
+            while (true) {
+                const int l = 2 * i + 1, r = l + 1;
+                int min = i;
+                if (l < len && key[heap[l]] < key[heap[min]]) min = l;
+                if (r < len && key[heap[r]] < key[heap[min]]) min = r;
+                if (min == i) return;
+                swap(i, min);
+                i = min;
+            }
+        }
+
+    public:
+        IndexedMinHeap(const int n) {
+            heap = new int[n];
+            pos = new int[n];
+            key = new int[n];
+            for (int i = 0; i < n; i++) pos[i] = -1;
+        }
+
+        ~IndexedMinHeap() {
+            delete[] heap;
+            delete[] pos;
+            delete[] key;
+        }
+
+        bool contains(const int id) const { return pos[id] != -1; }
+
+        int keyOf(const int id) const { return key[id]; }
+
+        void insert(const int id, const int k) {
+            if (contains(id)) throw std::invalid_argument("id is already in heap");
+            heap[len] = id;
+            pos[id] = len;
+            key[id] = k;
+            siftUp(len++);
+        }
+
+        void decreaseKey(const int id, const int k) {
+            if (!contains(id)) throw std::invalid_argument("id is not in heap");
+            if (k > key[id]) throw std::invalid_argument("key can only decrease");
+            key[id] = k;
+            siftUp(pos[id]);
+        }
+
+        // insert id, or lower its key if it's already queued with a bigger one
+        void push(const int id, const int k) {
+            if (!contains(id)) insert(id, k);
+            else if (k < key[id]) decreaseKey(id, k);
+        }
+
+        int peekMin() const {
+            if (len == 0) throw std::out_of_range("Heap is empty");
+            return heap[0];
+        }
+
+        int popMin() {
+            const int min = peekMin();
+            swap(0, --len);
+            pos[min] = -1;
+            siftDown(0);
+            return min;
+        }
+
+        bool isEmpty() const { return len == 0; }
+
+        int size() const { return len; }
+
+        // O(size) rather than O(n), for reusing one heap over many small searches
+        void clear() {
+            while (len > 0) pos[heap[--len]] = -1;
+        }
+    };
+
+    /**
+     * Monotone radix heap keyed by vertex id, with decrease-key. Keys must be non-negative and never below the last
+     * popped key (as in djikstra), so each key sits in bucket = index of the highest bit where it differs from the
+     * last popped key. A pop that finds bucket 0 empty takes the first non-empty bucket, makes its minimum the new
+     * last key and spreads it over lower buckets; every key only moves down, at most 32 times overall.
+     */
+    class RadixHeap {
+        static constexpr int BUCKETS = 33;
+        ArrayList<int> buckets[BUCKETS];
+        int *bucket_of, *pos, *key;
+        unsigned last = 0;
+        int len = 0;
+
+        int bucketOf(const int k) const {
+            const unsigned diff = static_cast<unsigned>(k) ^ last;
+            return diff == 0 ? 0 : 32 - __builtin_clz(diff);
+        }
+
+        void place(const int id) {
+            const int b = bucketOf(key[id]);
+            bucket_of[id] = b;
+            pos[id] = buckets[b].size();
+            buckets[b].add(id);
+        }
+
+        // swap remove, O(1)
+        void unplace(const int id) {
+            ArrayList<int> &bucket = buckets[bucket_of[id]];
+            const int moved = bucket[bucket.size() - 1];
+            bucket[pos[id]] = moved;
+            pos[moved] = pos[id];
+            bucket.pop();
+            bucket_of[id] = -1;
+        }
+
+    public:
+        RadixHeap(const int n) {
+            bucket_of = new int[n];
+            pos = new int[n];
+            key = new int[n];
+            for (int i = 0; i < n; i++) bucket_of[i] = -1;
+        }
+
+        ~RadixHeap() {
+            delete[] bucket_of;
+            delete[] pos;
+            delete[] key;
+        }
+
+        bool contains(const int id) const { return bucket_of[id] != -1; }
+
+        int keyOf(const int id) const { return key[id]; }
+
+        void insert(const int id, const int k) {
+            if (contains(id)) throw std::invalid_argument("id is already in heap");
+            if (k < 0 || static_cast<unsigned>(k) < last) throw std::invalid_argument("key is below the last popped key");
+            key[id] = k;
+            place(id);
+            len++;
+        }
+
+        void decreaseKey(const int id, const int k) {
+            if (!contains(id)) throw std::invalid_argument("id is not in heap");
+            if (k > key[id]) throw std::invalid_argument("key can only decrease");
+            if (static_cast<unsigned>(k) < last) throw std::invalid_argument("key is below the last popped key");
+            unplace(id);
+            key[id] = k;
+            place(id);
+        }
+
+        // insert id, or lower its key if it's already queued with a bigger one
+        void push(const int id, const int k) {
+            if (!contains(id)) insert(id, k);
+            else if (k < key[id]) decreaseKey(id, k);
+        }
+
+        int popMin() {
+            if (len == 0) throw std::out_of_range("Heap is empty");
+            if (buckets[0].isEmpty()) {
+                int b = 1;
+                while (buckets[b].isEmpty()) b++;
+                ArrayList<int> &bucket = buckets[b];
+                int min = bucket[0];
+                for (int i = 1; i < bucket.size(); i++) if (key[bucket[i]] < key[min]) min = bucket[i];
+                last = static_cast<unsigned>(key[min]);
+                // every key in bucket b shares the bits above b with the new last key, so they all land lower
+                for (int i = 0; i < bucket.size(); i++) place(bucket[i]);
+                bucket.clear();
+            }
+            const int min = buckets[0][buckets[0].size() - 1];
+            unplace(min);
+            len--;
+            return min;
+        }
+
+        bool isEmpty() const { return len == 0; }
+
+        int size() const { return len; }
+
+        void clear() {
+            for (auto &bucket: buckets) {
+                for (int i = 0; i < bucket.size(); i++) bucket_of[bucket[i]] = -1;
+                bucket.clear();
+            }
+            last = 0;
+            len = 0;
+        }
+    };
+
+    /**
+     * Union find safe to share between threads, without locks.
+     * Union by index: a root is only ever linked (by CAS) under a smaller root, so parents strictly decrease
+     * along any path, and find (path halving by CAS) finishes in a bounded number of steps.
+     */
+    class ConcurrentUnionSet {
+        std::atomic<int> *parent;
+
+    public:
+        ConcurrentUnionSet(const int n) {
+            parent = new std::atomic<int>[n];
+            for (int i = 0; i < n; i++) parent[i].store(i, std::memory_order_relaxed);
+        }
+
+        ~ConcurrentUnionSet() {
+            delete[] parent;
+        }
+
+        int find(int i) {
+            while (true) {
+                int p = parent[i].load();
+                if (p == i) return i;
+                const int gp = parent[p].load();
+                // path halving, if another thread got there first that's fine too
+                if (p != gp) parent[i].compare_exchange_weak(p, gp);
+                i = gp;
+            }
+        }
+
+        // returns whether x and y were in different sets (and this call joined them)
+        bool unite(int x, int y) {
+            while (true) {
+                x = find(x);
+                y = find(y);
+                if (x == y) return false;
+                if (x < y) {
+                    const int tmp = x;
+                    x = y;
+                    y = tmp;
+                }
+                // link the bigger root under the smaller, fails if x stopped being a root meanwhile
+                int expected = x;
+                if (parent[x].compare_exchange_strong(expected, y)) return true;
+            }
+        }
+
+        bool same(int x, int y) {
+            while (true) {
+                x = find(x);
+                y = find(y);
+                if (x == y) return true;
+                // x was still a root after y's find, so they really are apart at this point
+                if (parent[x].load() == x) return false;
+            }
+        }
+    };
+
+    /**
+     * Open addressing (linear probing) hash map from 64 bit keys to ints.
+     * Deletion shifts the following cluster back, so there are no tombstones. Capacity doubles past 1/2 load.
+     */
+    class HashIndex {
+        static constexpr unsigned long long EMPTY = ~0ULL; // reserved, can't be used as a key
+
+        unsigned long long *keys;
+        int *values;
+        int capacity, len = 0;
+
+        static unsigned long long hash(unsigned long long key) {
+            // splitmix64 finalizer
+            key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+            return key ^ (key >> 31);
+        }
+
+        int slot(const unsigned long long key) const {
+            int i = static_cast<int>(hash(key) & (capacity - 1));
+            while (keys[i] != EMPTY && keys[i] != key) i = (i + 1) & (capacity - 1);
+            return i;
+        }
+
+        void allocate(const int capacity) {
+            this->capacity = capacity;
+            keys = new unsigned long long[capacity];
+            values = new int[capacity];
+            for (int i = 0; i < capacity; i++) keys[i] = EMPTY;
+        }
+
+        void grow() {
+            const auto old_keys = keys;
+            const auto old_values = values;
+            const int old_capacity = capacity;
+            allocate(2 * capacity);
+            for (int i = 0; i < old_capacity; i++)
+                if (old_keys[i] != EMPTY) {
+                    const int j = slot(old_keys[i]);
+                    keys[j] = old_keys[i];
+                    values[j] = old_values[i];
+                }
+            delete[] old_keys;
+            delete[] old_values;
+        }
+
+    public:
+        HashIndex(const int expected = 8) {
+            int capacity = 16;
+            while (capacity < 2 * expected) capacity *= 2;
+            allocate(capacity);
+        }
+
+        ~HashIndex() {
+            delete[] keys;
+            delete[] values;
+        }
+
+        bool contains(const unsigned long long key) const { return keys[slot(key)] == key; }
+
+        const int *find(const unsigned long long key) const {
+            const int i = slot(key);
+            return keys[i] == key ? &values[i] : nullptr;
+        }
+
+        void put(const unsigned long long key, const int value) {
+            if (key == EMPTY) throw std::invalid_argument("reserved key");
+            int i = slot(key);
+            if (keys[i] != key) {
+                if (2 * (len + 1) > capacity) {
+                    grow();
+                    i = slot(key);
+                }
+                keys[i] = key;
+                len++;
+            }
+            values[i] = value;
+        }
+
+        bool remove(const unsigned long long key) {
+            int i = slot(key);
+            if (keys[i] != key) return false;
+            keys[i] = EMPTY;
+            len--;
+            // shift back every following entry of the cluster that can't be reached past the new hole
+            for (int j = (i + 1) & (capacity - 1); keys[j] != EMPTY; j = (j + 1) & (capacity - 1)) {
+                const int home = static_cast<int>(hash(keys[j]) & (capacity - 1));
+                // keep j in place if its home is cyclically in (i, j]
+                if (i <= j ? (i < home && home <= j) : (i < home || home <= j)) continue;
+                keys[i] = keys[j];
+                values[i] = values[j];
+                keys[j] = EMPTY;
+                i = j;
+            }
+            return true;
+        }
+
+        int size() const { return len; }
+    };
+
+    /**
+     * Reusable thread barrier: wait() blocks until count threads arrived,
+     * then the last one to arrive runs completion (while the rest are still blocked) and releases all.
+     */
+    class Barrier {
+        std::mutex mutex;
+        std::condition_variable cv;
+        const int count;
+        int waiting = 0;
+        long generation = 0;
+        const std::function<void()> completion;
+
+    public:
+        Barrier(const int count, std::function<void()> completion = nullptr)
+            : count(count), completion(std::move(completion)) {
+        }
+
+        void wait() {
+            std::unique_lock<std::mutex> lock(mutex);
+            const auto gen = generation;
+            if (++waiting == count) {
+                if (completion) completion();
+                waiting = 0;
+                generation++;
+                cv.notify_all();
+            } else {
+                cv.wait(lock, [&] { return gen != generation; });
+            }
+        }
+    };
+
     template class Queue<int>;
 }
 
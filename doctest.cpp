@@ -1,5 +1,7 @@
 #include <iostream>
 #include <ostream>
+#include <sstream>
+#include <thread>
 
 #include "graph.h"
 
@@ -9,6 +11,32 @@
 using std::cout,std::endl;
 using namespace graphs;
 
+// next pseudo random int in [0, mod), a linear congruential step on seed
+static int lcg(unsigned &seed, const int mod) {
+    return static_cast<int>((seed = seed * 1103515245 + 12345) >> 8) % mod;
+}
+
+// sum of weights along a path's edges, or -1 if it doesn't start/end right or uses a missing edge
+static int path_weight(const Graph *g, const Path *path) {
+    if (path->length == 0 || path->vertices[0] != path->src || path->vertices[path->length - 1] != path->dst)
+        return -1;
+    int sum = 0;
+    for (int i = 1; i < path->length; i++) {
+        const int u = path->vertices[i - 1], v = path->vertices[i];
+        if (!g->neighbour_list[u].contains(v)) return -1;
+        sum += g->weight(u, v);
+    }
+    return sum;
+}
+
+// pseudo random weighted graph, a spanning path plus extra edges
+static Graph *random_graph(const int n, const int extra, const bool directed, unsigned seed) {
+    const auto g = new Graph(n, directed);
+    for (int v = 1; v < n; v++) g->addEdge(v - 1, v, lcg(seed, 20));
+    for (int i = 0; i < extra; i++) g->addEdge(lcg(seed, n), lcg(seed, n), lcg(seed, 20));
+    return g;
+}
+
 TEST_SUITE("graphs") {
     TEST_CASE("Create") {
         cout << "Testing graph creation" << endl;
@@ -58,6 +86,289 @@ TEST_SUITE("graphs") {
 
         delete g;
     }
+
+    TEST_CASE("From edges") {
+        cout << "Testing bulk graph build" << endl;
+        const Graph::WeightedEdge edges[] = {
+            {3, 1, 5}, {0, 2}, {2, 0, 7}, {1, 3, 2}, {4, 4}, {0, 1, 3}, {2, 4, -1}, {0, 2, 9}
+        };
+        constexpr int count = sizeof(edges) / sizeof(edges[0]);
+
+        for (const bool directed: {false, true}) {
+            const auto bulk = Graph::fromEdges(5, directed, edges, count);
+            const auto one_by_one = new Graph(5, directed);
+            for (const auto &e: edges) one_by_one->addEdge(e.u, e.v, e.weight);
+
+            CHECK_EQ(bulk->m(), one_by_one->m());
+            CHECK_EQ(bulk->weight(), one_by_one->weight());
+            for (int u = 0; u < 5; u++) {
+                CHECK_EQ(bulk->neighbour_list[u].length(), one_by_one->neighbour_list[u].length());
+                for (int v = 0; v < 5; v++) {
+                    CHECK_EQ(bulk->hasEdge(u, v), one_by_one->hasEdge(u, v));
+                    if (u != v && one_by_one->hasEdge(u, v) && one_by_one->neighbour_list[u].contains(v))
+                        CHECK_EQ(bulk->weight(u, v), one_by_one->weight(u, v));
+                }
+            }
+
+            delete bulk;
+            delete one_by_one;
+        }
+
+        const Graph::WeightedEdge bad[] = {{0, 5}};
+        CHECK_THROWS(Graph::fromEdges(5, false, bad, 1));
+    }
+
+    TEST_CASE("Edge index") {
+        cout << "Testing hash indexed edges" << endl;
+
+        for (const bool directed: {false, true}) {
+            auto g = new Graph(50, directed);
+            g->addEdge(0, 1, 4);
+            g->buildEdgeIndex();
+            CHECK(g->hasEdgeIndex());
+            CHECK(g->hasEdge(0, 1));
+            CHECK_EQ(g->hasEdge(1, 0), !directed);
+            CHECK_EQ(g->weight(0, 1), 4);
+
+            for (int u = 0; u < g->n; u++)
+                for (int v = u + 1; v < g->n; v += 3)
+                    g->addEdge(u, v, u + v);
+            g->addEdge(0, 1, 9); // duplicate, ignored
+            CHECK_EQ(g->weight(0, 1), 4);
+            CHECK_EQ(g->weight(10, 14), 24);
+            CHECK_THROWS(g->weight(10, 12));
+
+            const int m = g->m();
+            g->deleteEdge(10, 14);
+            CHECK(!g->hasEdge(10, 14));
+            CHECK(!g->hasEdge(14, 10));
+            CHECK_EQ(g->m(), m - 1);
+            g->addEdge(10, 14, 1);
+            CHECK_EQ(g->weight(10, 14), 1);
+
+            delete g;
+        }
+    }
+}
+
+TEST_SUITE("data structures") {
+    TEST_CASE("LinkedList tail") {
+        cout << "Testing linked list tail upkeep" << endl;
+        LinkedList<int> l;
+        CHECK(!l.removeValue(1));
+        l.addFirst(1);
+        CHECK_EQ(l.tail->val, 1);
+        l.addLast(2);
+        l.addLast(3);
+        CHECK_EQ(l.tail->val, 3);
+        CHECK(l.removeValue(3));
+        CHECK_EQ(l.tail->val, 2);
+        l.addLast(4);
+        CHECK_EQ(l.tail->val, 4);
+        CHECK(l.deleteLast());
+        CHECK_EQ(l.tail->val, 2);
+        CHECK(l.deleteFirst());
+        CHECK(l.deleteFirst());
+        CHECK(l.tail == nullptr);
+        l.addLast(5);
+        CHECK_EQ(l.head->val, 5);
+        CHECK(l.head == l.tail);
+        l.clear();
+        CHECK(l.tail == nullptr);
+
+        Queue<int> q;
+        for (int i = 0; i < 10; i++) q.insert(i);
+        for (int i = 0; i < 10; i++) CHECK_EQ(q.pop(), i);
+        q.insert(10);
+        CHECK_EQ(q.pop(), 10);
+    }
+
+    TEST_CASE("Pooled LinkedList") {
+        cout << "Testing pooled linked list" << endl;
+        SlabPool<LinkedList<int>::Link<int> > pool;
+        {
+            LinkedList<int> a(&pool), b(&pool);
+            for (int i = 0; i < 100; i++) a.addLast(i), b.addFirst(i);
+            CHECK_EQ(a.length(), 100);
+            CHECK_EQ(a.head->val, 0);
+            CHECK_EQ(b.head->val, 99);
+            CHECK(a.removeValue(50));
+            CHECK(!a.contains(50));
+            CHECK(a.deleteLast());
+            a.addLast(-1); // recycled link
+            CHECK_EQ(a.length(), 99);
+            CHECK(a.contains(-1));
+            CHECK_THROWS(a.setPool(nullptr));
+        }
+    }
+
+    TEST_CASE("UnionSet") {
+        cout << "Testing union sets" << endl;
+        constexpr int n = 100000;
+        // a long chain, deep enough to have overflowed a recursive find
+        UnionSet chain(n);
+        for (int i = 1; i < n; i++) chain.unite(i - 1, i);
+        CHECK_EQ(chain.find(0), chain.find(n - 1));
+
+        ConcurrentUnionSet sets(n);
+        CHECK(!sets.same(0, 1));
+        CHECK(sets.unite(0, 1));
+        CHECK(!sets.unite(1, 0));
+        CHECK(sets.same(1, 0));
+
+        // threads racing to join evens and odds into two sets
+        ConcurrentUnionSet parity(n);
+        std::thread threads[4];
+        for (int t = 0; t < 4; t++)
+            threads[t] = std::thread([&parity, t] {
+                for (int i = 2 + t; i < n; i += 4) parity.unite(i, i - 2);
+            });
+        for (auto &thread: threads) thread.join();
+        CHECK(parity.same(0, n - 2));
+        CHECK(parity.same(1, n - 1));
+        CHECK(!parity.same(0, n - 1));
+        CHECK_EQ(parity.find(n - 2), 0);
+        CHECK_EQ(parity.find(n - 1), 1);
+    }
+
+    TEST_CASE("HashIndex") {
+        cout << "Testing hash index" << endl;
+        HashIndex h;
+        for (int i = 0; i < 1000; i++) h.put(i * 7919ULL, i);
+        CHECK_EQ(h.size(), 1000);
+        for (int i = 0; i < 1000; i += 2) CHECK(h.remove(i * 7919ULL));
+        CHECK(!h.remove(0));
+        CHECK_EQ(h.size(), 500);
+        for (int i = 0; i < 1000; i++) {
+            const auto v = h.find(i * 7919ULL);
+            if (i % 2) {
+                REQUIRE(v != nullptr);
+                CHECK_EQ(*v, i);
+            } else CHECK(v == nullptr);
+        }
+        h.put(7919ULL, -1);
+        CHECK_EQ(*h.find(7919ULL), -1);
+        CHECK_THROWS(h.put(~0ULL, 0));
+    }
+
+    TEST_CASE("IndexedMinHeap") {
+        cout << "Testing indexed min heap" << endl;
+        IndexedMinHeap h(5);
+        CHECK(h.isEmpty());
+        CHECK_THROWS(h.popMin());
+
+        h.insert(0, 7);
+        h.insert(1, 3);
+        h.insert(2, 9);
+        h.push(3, 5);
+        CHECK_EQ(h.size(), 4);
+        CHECK(!h.contains(4));
+        CHECK_THROWS(h.insert(1, 0));
+
+        h.decreaseKey(2, 1);
+        CHECK_THROWS(h.decreaseKey(0, 8));
+        h.push(0, 10); // bigger key is ignored
+        CHECK_EQ(h.keyOf(0), 7);
+
+        CHECK_EQ(h.popMin(), 2);
+        CHECK_EQ(h.popMin(), 1);
+        CHECK_EQ(h.popMin(), 3);
+        CHECK_EQ(h.popMin(), 0);
+        CHECK(h.isEmpty());
+        CHECK(!h.contains(0));
+    }
+
+    TEST_CASE("RadixHeap") {
+        cout << "Testing radix heap" << endl;
+        RadixHeap h(6);
+        CHECK(h.isEmpty());
+        CHECK_THROWS(h.popMin());
+        CHECK_THROWS(h.insert(0, -1));
+
+        h.insert(0, 70);
+        h.insert(1, 3);
+        h.insert(2, 1 << 20);
+        h.push(3, 5);
+        h.insert(4, 5);
+        CHECK_EQ(h.size(), 5);
+        CHECK(!h.contains(5));
+        CHECK_THROWS(h.insert(1, 0));
+
+        h.decreaseKey(2, 4);
+        CHECK_THROWS(h.decreaseKey(0, 80));
+        h.push(0, 100); // bigger key is ignored
+        CHECK_EQ(h.keyOf(0), 70);
+
+        CHECK_EQ(h.popMin(), 1);
+        CHECK_THROWS(h.insert(5, 2)); // below the last popped key
+        CHECK_EQ(h.popMin(), 2);
+        h.push(5, 4);
+        CHECK_EQ(h.popMin(), 5);
+        const int a = h.popMin(), b = h.popMin();
+        CHECK_EQ(a + b, 3 + 4);
+        CHECK_EQ(h.popMin(), 0);
+        CHECK(h.isEmpty());
+
+        h.insert(1, 90);
+        h.clear();
+        CHECK(h.isEmpty());
+        CHECK(!h.contains(1));
+        h.insert(1, 0); // clear resets the last popped key
+
+        for (const bool directed: {false, true}) {
+            const auto g = random_graph(500, 3000, directed, directed ? 15 : 16);
+            const CSRGraph csr(g);
+            for (const int src: {0, 250, 499}) {
+                const auto binary = Algorithms::djikstraTree(g, src);
+                const auto radix = Algorithms::djikstraTree(g, src, Algorithms::Heap::Radix);
+                const auto radix_csr = Algorithms::djikstraTree(csr, src, Algorithms::Heap::Radix);
+                for (int v = 0; v < g->n; v++) {
+                    CHECK_EQ(radix->dist[v], binary->dist[v]);
+                    CHECK_EQ(radix_csr->dist[v], binary->dist[v]);
+                }
+                delete binary;
+                delete radix;
+                delete radix_csr;
+            }
+            delete g;
+        }
+
+        // 0 -> 2 sums past INT_MAX: it must neither wrap below the last popped key nor relax at all
+        const auto heavy = new Graph(3, true);
+        heavy->addEdge(0, 1, INT_MAX - 5);
+        heavy->addEdge(1, 2, INT_MAX - 5);
+        const auto tree = Algorithms::djikstraTree(heavy, 0, Algorithms::Heap::Radix);
+        CHECK_EQ(tree->dist[1], INT_MAX - 5);
+        CHECK(!tree->reached(2));
+        delete tree;
+        delete heavy;
+    }
+
+    TEST_CASE("RingQueue & Bitmap") {
+        cout << "Testing ring queue and bitmap" << endl;
+        RingQueue<int> q(3);
+        CHECK_THROWS(q.pop());
+        q.insert(1);
+        q.insert(2);
+        CHECK_EQ(q.pop(), 1);
+        q.insert(3);
+        q.insert(4); // wraps around
+        CHECK_THROWS(q.insert(5));
+        CHECK_EQ(q.pop(), 2);
+        CHECK_EQ(q.pop(), 3);
+        CHECK_EQ(q.pop(), 4);
+        CHECK(q.isEmpty());
+
+        Bitmap b(130);
+        CHECK(!b.get(129));
+        b.set(129);
+        b.set(0);
+        CHECK(b.get(129));
+        CHECK(b.get(0));
+        CHECK(!b.get(64));
+        b.unset(129);
+        CHECK(!b.get(129));
+    }
 }
 
 TEST_SUITE("algorithms") {
@@ -68,6 +379,8 @@ TEST_SUITE("algorithms") {
         CHECK_THROWS(Algorithms::djikstra(nullptr, 0));
         CHECK_THROWS(Algorithms::prim(nullptr, 0));
         CHECK_THROWS(Algorithms::kruskal(nullptr));
+        CHECK_THROWS(Algorithms::filterKruskal(nullptr));
+        CHECK_THROWS(Algorithms::boruvka(nullptr));
     }
 
     TEST_CASE("empty") {
@@ -78,7 +391,614 @@ TEST_SUITE("algorithms") {
         CHECK_THROWS(Algorithms::djikstra(g, 0));
         CHECK_THROWS(Algorithms::prim(g, 0));
         CHECK_THROWS(Algorithms::kruskal(g));
+        CHECK_THROWS(Algorithms::filterKruskal(g));
+        CHECK_THROWS(Algorithms::boruvka(g));
+        delete g;
+    }
+
+    TEST_CASE("Hybrid & parallel BFS") {
+        cout << endl << "Testing direction-optimizing and parallel bfs" << endl;
+
+        // dense-ish graph so bottom-up steps kick in, plus a directed tail and an unreachable node
+        const auto g = new Graph(40, true);
+        for (int u = 0; u < 30; u++)
+            for (int v = 0; v < 30; v++)
+                if (u != v && (u * 7 + v * 3) % 5 == 0) g->addEdge(u, v);
+        for (int v = 30; v < 38; v++) g->addEdge(v - 1, v);
+        g->addEdge(39, 0);
+        const CSRGraph csr(g);
+
+        const auto expected = Algorithms::bfsTree(g, 0);
+        for (const auto tree: {Algorithms::bfsHybrid(g, 0), Algorithms::bfsHybrid(csr, 0),
+                               Algorithms::bfsHybrid(g, 0, 1, 1), Algorithms::bfsParallel(g, 0, 4),
+                               Algorithms::bfsParallel(csr, 0, 1), Algorithms::bfsParallel(csr, 0)}) {
+            for (int v = 0; v < g->n; v++) {
+                CHECK_EQ(tree->dist[v], expected->dist[v]);
+                if (v != 0 && tree->reached(v)) {
+                    // parent must be a real edge one level up
+                    CHECK(g->hasEdge(tree->parent[v], v));
+                    CHECK_EQ(tree->dist[tree->parent[v]] + 1, tree->dist[v]);
+                }
+            }
+            CHECK(!tree->reached(39));
+            delete tree;
+        }
+
+        delete expected;
+        delete g;
+    }
+
+    TEST_CASE("DFS forest") {
+        cout << endl << "Testing iterative dfs" << endl;
+
+        // path far deeper than a recursive dfs could take
+        constexpr int n = 1000000;
+        const auto path = new Graph(n);
+        for (int v = 1; v < n; v++) path->addEdge(v - 1, v);
+        const auto deep = Algorithms::dfsForest(path, 0);
+        CHECK_EQ(deep->parent[n - 1], n - 2);
+        CHECK_EQ(deep->discovery[n - 1], n - 1);
+        CHECK_EQ(deep->finish[0], 2 * n - 1);
+        delete deep;
+        delete path;
+
+        // 3 trees, visited from src = 4 and wrapping around
+        const auto g = new Graph(7);
+        g->addEdge(0, 1);
+        g->addEdge(1, 2);
+        g->addEdge(4, 5);
+        g->addEdge(4, 6);
+        const auto forest = Algorithms::dfsForest(g, 4);
+        CHECK_EQ(forest->parent[4], -1);
+        CHECK_EQ(forest->parent[0], -1);
+        CHECK_EQ(forest->parent[3], -1);
+        CHECK_EQ(forest->parent[2], 1);
+        CHECK_EQ(forest->discovery[4], 0);
+        CHECK_EQ(forest->trees, 3);
+        CHECK_EQ(forest->tree[6], 0);
+        CHECK_EQ(forest->tree[2], 1);
+        CHECK_EQ(forest->tree[3], 2);
+        const auto tree_1 = forest->toGraph(1);
+        CHECK_EQ(tree_1->m(), 2);
+        CHECK(tree_1->hasEdge(0, 1));
+        CHECK(!tree_1->hasEdge(4, 5));
+        delete tree_1;
+        CHECK_THROWS(forest->toGraph(3));
+        std::ostringstream printed;
+        printed << *forest;
+        CHECK_EQ(printed.str(), "3-tree dfs forest:\nTree [0]: (4)\t4)--(5\t4)--(6\t\n"
+                 "Tree [1]: (0)\t0)--(1\t1)--(2\t\nTree [2]: (3)\t\n");
+        for (int v = 0; v < g->n; v++) {
+            CHECK(forest->discovery[v] < forest->finish[v]);
+            // a child's interval nests in its parent's
+            if (const int p = forest->parent[v]; p != -1) {
+                CHECK(forest->discovery[p] < forest->discovery[v]);
+                CHECK(forest->finish[v] < forest->finish[p]);
+            }
+        }
+        delete forest;
+
+        const auto trees = Algorithms::dfs(g, 4);
+        int count = 0;
+        for (int v = 0; v < g->n; v++)
+            if (trees[v]) count++;
+        CHECK_EQ(count, 3);
+        CHECK(trees[4]->hasEdge(4, 6));
+        CHECK(trees[0]->hasEdge(1, 2));
+        CHECK_EQ(trees[3]->m(), 0);
+        for (int v = 0; v < g->n; v++)
+            delete trees[v];
+        delete[] trees;
+        delete g;
+    }
+
+    TEST_CASE("Connected components") {
+        cout << endl << "Testing connected components" << endl;
+
+        for (const bool directed: {false, true}) {
+            // a giant component (0..299), 5 small ones, and isolated nodes
+            const auto g = new Graph(400, directed);
+            unsigned seed = 7;
+            for (int v = 1; v < 300; v++) g->addEdge(lcg(seed, v), v);
+            for (int i = 0; i < 600; i++) g->addEdge(lcg(seed, 300), lcg(seed, 300));
+            for (int c = 0; c < 5; c++)
+                for (int v = 301 + c * 10; v < 310 + c * 10; v++) g->addEdge(v - 1, v);
+
+            const CSRGraph csr(g);
+            for (const auto components: {Algorithms::connectedComponents(g), Algorithms::connectedComponents(csr),
+                                         Algorithms::connectedComponentsParallel(g, 4),
+                                         Algorithms::connectedComponentsParallel(csr)}) {
+                CHECK_EQ(components->count, 1 + 5 + 50);
+                CHECK_EQ(components->id[0], 0);
+                CHECK_EQ(components->size[0], 300);
+                CHECK_EQ(components->id[299], 0);
+                CHECK_EQ(components->id[300], 1);
+                CHECK_EQ(components->size[1], 10);
+                CHECK_EQ(components->id[305], components->id[309]);
+                CHECK_NE(components->id[309], components->id[310]);
+                CHECK_EQ(components->size[components->id[399]], 1);
+                delete components;
+            }
+            delete g;
+        }
+    }
+
+    TEST_CASE("Strongly connected components") {
+        cout << endl << "Testing strongly connected components" << endl;
+
+        // {0,1,2} cycle -> {3,4} cycle -> 5, 6 -> 0, and {7,8,9} cycle with a chord
+        const auto g = new Graph(10, true);
+        g->addEdge(0, 1);
+        g->addEdge(1, 2);
+        g->addEdge(2, 0);
+        g->addEdge(2, 3);
+        g->addEdge(3, 4);
+        g->addEdge(4, 3);
+        g->addEdge(4, 5);
+        g->addEdge(6, 0);
+        g->addEdge(7, 8);
+        g->addEdge(8, 9);
+        g->addEdge(9, 7);
+        g->addEdge(7, 9);
+
+        const auto expected = Algorithms::stronglyConnectedComponents(g);
+        CHECK_EQ(expected->count, 5);
+        CHECK_EQ(expected->id[0], expected->id[2]);
+        CHECK_EQ(expected->id[3], expected->id[4]);
+        CHECK_NE(expected->id[2], expected->id[3]);
+        CHECK_EQ(expected->size[expected->id[7]], 3);
+        CHECK_EQ(expected->size[expected->id[6]], 1);
+
+        const CSRGraph csr(g);
+        for (const auto scc: {Algorithms::stronglyConnectedComponents(csr),
+                              Algorithms::stronglyConnectedComponentsParallel(g, 3),
+                              Algorithms::stronglyConnectedComponentsParallel(csr)}) {
+            CHECK_EQ(scc->count, expected->count);
+            for (int v = 0; v < g->n; v++) CHECK_EQ(scc->id[v], expected->id[v]);
+            delete scc;
+        }
+
+        const auto dag = Algorithms::condensation(g, expected);
+        CHECK_EQ(dag->n, 5);
+        CHECK(dag->directed);
+        CHECK_EQ(dag->m(), 3);
+        CHECK(dag->hasEdge(expected->id[0], expected->id[3]));
+        CHECK(dag->hasEdge(expected->id[6], expected->id[0]));
+        const auto dag_scc = Algorithms::stronglyConnectedComponents(dag);
+        CHECK_EQ(dag_scc->count, dag->n); // acyclic
+        delete dag_scc;
+        delete dag;
+        delete expected;
         delete g;
+
+        // one huge cycle (too deep for a recursive tarjan), and a long chain for the parallel trimming
+        constexpr int n = 1000000;
+        const auto cycle = new Graph(n, true), chain = new Graph(n, true);
+        for (int v = 0; v < n; v++) {
+            cycle->addEdge(v, (v + 1) % n);
+            if (v > 0) chain->addEdge(v, v - 1);
+        }
+        for (const auto one: {Algorithms::stronglyConnectedComponents(cycle),
+                              Algorithms::stronglyConnectedComponentsParallel(cycle, 3)}) {
+            CHECK_EQ(one->count, 1);
+            delete one;
+        }
+        const auto all = Algorithms::stronglyConnectedComponentsParallel(chain);
+        CHECK_EQ(all->count, n);
+        delete all;
+        delete cycle;
+        delete chain;
+
+        // two cycles joined by a long path trimming can't peel, whose ids fall along it (so the max id coloring
+        // floods it end to end), plus random graphs
+        constexpr int ring = 1000, path = 100000;
+        const auto joined = new Graph(2 * ring + path, true);
+        for (int v = 0; v < ring; v++) {
+            joined->addEdge(path + v, path + (v + 1) % ring);
+            joined->addEdge(path + ring + v, path + ring + (v + 1) % ring);
+        }
+        joined->addEdge(path, path - 1);
+        for (int v = path - 1; v > 0; v--) joined->addEdge(v, v - 1);
+        joined->addEdge(0, path + ring);
+        for (const auto graph: {joined, random_graph(300, 600, true, 7), random_graph(2000, 2500, true, 8)}) {
+            const auto tarjan = Algorithms::stronglyConnectedComponents(graph);
+            for (const int threads: {1, 4}) {
+                const auto scc = Algorithms::stronglyConnectedComponentsParallel(graph, threads);
+                CHECK_EQ(scc->count, tarjan->count);
+                for (int v = 0; v < graph->n; v++) CHECK_EQ(scc->id[v], tarjan->id[v]);
+                delete scc;
+            }
+            delete tarjan;
+            delete graph;
+        }
+    }
+
+    TEST_CASE("MST") {
+        cout << endl << "Testing mst algorithms agree" << endl;
+
+        // pseudo random connected graph: a path plus extra edges, with repeated weights
+        const auto g = new Graph(200);
+        unsigned seed = 12345;
+        for (int v = 1; v < g->n; v++) g->addEdge(v - 1, v, lcg(seed, 50));
+        for (int i = 0; i < 2000; i++) g->addEdge(lcg(seed, g->n), lcg(seed, g->n), lcg(seed, 50));
+
+        const auto prim = Algorithms::prim(g, 0), kruskal = Algorithms::kruskal(g);
+        CHECK_EQ(kruskal->m(), g->n - 1);
+        CHECK_EQ(kruskal->weight(), prim->weight());
+        for (const auto mst: {Algorithms::filterKruskal(g), Algorithms::filterKruskal(CSRGraph(g)),
+                              Algorithms::boruvka(g), Algorithms::boruvka(g, 1), Algorithms::boruvka(CSRGraph(g), 3)}) {
+            CHECK_EQ(mst->m(), g->n - 1);
+            CHECK_EQ(mst->weight(), prim->weight());
+            delete mst;
+        }
+        delete prim;
+        delete kruskal;
+
+        // kruskal on a disconnected graph is a spanning forest
+        const auto split = new Graph(6);
+        split->addEdge(0, 1, 3);
+        split->addEdge(1, 2, 1);
+        split->addEdge(0, 2, 1);
+        split->addEdge(3, 4, 2);
+        for (const auto forest: {Algorithms::kruskal(split), Algorithms::filterKruskal(split),
+                                 Algorithms::boruvka(split, 2)}) {
+            CHECK_EQ(forest->m(), 3);
+            CHECK_EQ(forest->weight(), 4);
+            delete forest;
+        }
+        delete split;
+
+        delete g;
+    }
+
+    TEST_CASE("Point to point") {
+        cout << endl << "Testing point to point shortest paths" << endl;
+
+        for (const bool directed: {false, true}) {
+            const auto g = random_graph(60, 150, directed, directed ? 3 : 4);
+            g->addEdge(59, 0, 100);
+            const CSRGraph csr(g);
+            const auto reversed = directed ? CSRGraph::transpose(&csr) : &csr;
+            // engines answer every query below, so each one must leave its scratch clean for the next
+            const BidirectionalDjikstra engine(g), csr_engine(csr), given_engine(csr, reversed);
+            for (int src = 0; src < g->n; src += 7) {
+                const auto tree = Algorithms::djikstraTree(g, src);
+                for (int dst = 0; dst < g->n; dst++) {
+                    const auto tree_path = tree->pathTo(dst);
+                    CHECK_EQ(path_weight(g, tree_path), tree->dist[dst]);
+                    delete tree_path;
+
+                    for (const auto path: {Algorithms::bidirectionalDjikstra(g, src, dst),
+                                           Algorithms::bidirectionalDjikstra(csr, src, dst),
+                                           engine.query(src, dst), csr_engine.query(src, dst),
+                                           given_engine.query(src, dst)}) {
+                        CHECK_EQ(path->dist, tree->dist[dst]);
+                        if (path->found()) CHECK_EQ(path_weight(g, path), path->dist);
+                        delete path;
+                    }
+                }
+                delete tree;
+            }
+            if (directed) delete reversed;
+            delete g;
+        }
+
+        const auto split = new Graph(3, true);
+        split->addEdge(0, 1, 2);
+        const auto none = Algorithms::bidirectionalDjikstra(split, 1, 0);
+        CHECK(!none->found());
+        CHECK_EQ(none->length, 0);
+        delete none;
+        const auto self = Algorithms::bidirectionalDjikstra(split, 2, 2);
+        CHECK_EQ(self->dist, 0);
+        CHECK_EQ(self->length, 1);
+        delete self;
+        CHECK_THROWS(Algorithms::bidirectionalDjikstra(split, 0, 3));
+        const BidirectionalDjikstra engine(split);
+        for (int i = 0; i < 2; i++) {
+            const auto found = engine.query(0, 1), lost = engine.query(1, 0);
+            CHECK_EQ(found->dist, 2);
+            CHECK_EQ(found->length, 2);
+            CHECK(!lost->found());
+            delete found;
+            delete lost;
+        }
+        CHECK_THROWS(engine.query(3, 0));
+        const auto smaller = new Graph(2, true);
+        const CSRGraph split_csr(split), smaller_csr(smaller);
+        CHECK_THROWS(BidirectionalDjikstra(split_csr, &smaller_csr));
+        delete smaller;
+        delete split;
+
+        // 0->1->2 sums past INT_MAX, so 2 is out of reach
+        const auto heavy = new Graph(3, true);
+        heavy->addEdge(0, 1, INT_MAX - 5);
+        heavy->addEdge(1, 2, INT_MAX - 5);
+        const auto near = Algorithms::bidirectionalDjikstra(heavy, 0, 1), far = Algorithms::bidirectionalDjikstra(heavy, 0, 2);
+        CHECK_EQ(near->dist, INT_MAX - 5);
+        CHECK(!far->found());
+        delete near;
+        delete far;
+        delete heavy;
+    }
+
+    TEST_CASE("A*") {
+        cout << endl << "Testing A*" << endl;
+
+        // 20x20 grid, nodes at integer coordinates, edge weight = length (+ a random detour) so both are admissible
+        constexpr int side = 20, n = side * side;
+        double x[n], y[n];
+        const auto grid = new Graph(n);
+        unsigned seed = 9;
+        for (int v = 0; v < n; v++) {
+            x[v] = v % side;
+            y[v] = v / side;
+            if (v % side > 0) grid->addEdge(v - 1, v, 1 + lcg(seed, 3));
+            if (v >= side) grid->addEdge(v - side, v, 1 + lcg(seed, 3));
+        }
+        const CSRGraph csr(grid);
+
+        for (const int src: {0, 37, 399}) {
+            const auto tree = Algorithms::djikstraTree(grid, src);
+            for (int dst = 0; dst < n; dst += 13) {
+                const auto euclid = Algorithms::astar(grid, src, dst, Heuristics::Euclidean(x, y));
+                const auto manhattan = Algorithms::astar(csr, src, dst, Heuristics::Manhattan(x, y));
+                const auto zero = Algorithms::astar(grid, src, dst, Heuristics::Zero());
+                // any callable works
+                const auto lambda = Algorithms::astar(grid, src, dst, [&x](const int v, const int t) {
+                    return static_cast<int>(std::fabs(x[v] - x[t]));
+                });
+                for (const auto path: {euclid, manhattan, zero, lambda}) {
+                    CHECK_EQ(path->dist, tree->dist[dst]);
+                    CHECK_EQ(path_weight(grid, path), path->dist);
+                    delete path;
+                }
+            }
+            delete tree;
+        }
+        delete grid;
+
+        const auto heavy = new Graph(3, true);
+        heavy->addEdge(0, 1, INT_MAX - 5);
+        heavy->addEdge(1, 2, INT_MAX - 5);
+        const auto near = Algorithms::astar(heavy, 0, 1, Heuristics::Zero()), far = Algorithms::astar(heavy, 0, 2, Heuristics::Zero());
+        CHECK_EQ(near->dist, INT_MAX - 5);
+        CHECK(!far->found());
+        delete near;
+        delete far;
+        delete heavy;
+    }
+
+    TEST_CASE("Delta stepping") {
+        cout << endl << "Testing delta stepping" << endl;
+
+        for (const bool directed: {false, true}) {
+            const auto g = random_graph(300, 1500, directed, directed ? 13 : 14);
+            g->addEdge(0, 299, 0);
+            const CSRGraph csr(g);
+            for (const int src: {0, 150}) {
+                const auto expected = Algorithms::djikstraTree(g, src);
+                for (const auto tree: {Algorithms::deltaStepping(g, src), Algorithms::deltaStepping(g, src, 1, 1),
+                                       Algorithms::deltaStepping(csr, src, 5, 4), Algorithms::deltaStepping(csr, src, 100)}) {
+                    for (int v = 0; v < g->n; v++) {
+                        CHECK_EQ(tree->dist[v], expected->dist[v]);
+                        if (const int p = tree->parent[v]; p != -1)
+                            CHECK_EQ(tree->dist[p] + g->weight(p, v), tree->dist[v]);
+                        else CHECK((v == src || !tree->reached(v)));
+                    }
+                    delete tree;
+                }
+                delete expected;
+            }
+            delete g;
+        }
+
+        // a tiny delta against a huge weight doesn't need huge bucket arrays
+        const auto heavy = new Graph(3, true);
+        heavy->addEdge(0, 1, 2000000000);
+        heavy->addEdge(0, 2, 3);
+        heavy->addEdge(2, 1, 1999999990);
+        const auto far = Algorithms::deltaStepping(heavy, 0, 1, 2);
+        CHECK_EQ(far->dist[1], 1999999993);
+        CHECK_EQ(far->parent[1], 2);
+        delete far;
+        delete heavy;
+
+        const auto g = new Graph(2);
+        CHECK_THROWS(Algorithms::deltaStepping(g, 0, -1));
+        g->addEdge(0, 1, -2);
+        CHECK_THROWS(Algorithms::deltaStepping(g, 0));
+        delete g;
+    }
+
+    TEST_CASE("Bellman-Ford") {
+        cout << endl << "Testing Bellman-Ford" << endl;
+
+        for (const bool directed: {false, true}) {
+            const auto g = random_graph(300, 1500, directed, directed ? 17 : 18);
+            const CSRGraph csr(g);
+            const auto expected = Algorithms::djikstraTree(g, 7);
+            for (const auto tree: {Algorithms::bellmanFord(g, 7), Algorithms::bellmanFord(csr, 7),
+                                   Algorithms::bellmanFordParallel(g, 7, 1), Algorithms::bellmanFordParallel(csr, 7, 4)}) {
+                for (int v = 0; v < g->n; v++) CHECK_EQ(tree->dist[v], expected->dist[v]);
+                delete tree;
+            }
+            delete expected;
+            delete g;
+        }
+
+        // reweighting by a potential, w(u, v) + p(u) - p(v), makes negative edges but keeps every cycle's weight,
+        // and shifts each shortest distance from src by p(src) - p(v)
+        const auto g = random_graph(200, 1000, true, 19);
+        const auto p = [](const int v) { return v * 37 % 50; };
+        const auto shifted = new Graph(g->n, true);
+        for (int u = 0; u < g->n; u++)
+            for (auto it = g->neighbours(u); !it.done(); it.next())
+                shifted->addEdge(u, it.vertex(), it.weight() + p(u) - p(it.vertex()));
+        const auto expected = Algorithms::djikstraTree(g, 3);
+        for (const auto tree: {Algorithms::bellmanFord(shifted, 3), Algorithms::bellmanFordParallel(shifted, 3)}) {
+            for (int v = 0; v < g->n; v++) {
+                if (!expected->reached(v)) CHECK(!tree->reached(v));
+                else CHECK_EQ(tree->dist[v], expected->dist[v] + p(3) - p(v));
+                if (const int parent = tree->parent[v]; parent != -1)
+                    CHECK_EQ(tree->dist[parent] + shifted->weight(parent, v), tree->dist[v]);
+            }
+            const auto path = tree->pathTo(g->n - 1);
+            CHECK_EQ(path_weight(shifted, path), tree->dist[g->n - 1]);
+            delete path;
+            delete tree;
+        }
+        CHECK_THROWS(Algorithms::djikstraTree(shifted, 3));
+        delete expected;
+        delete shifted;
+        delete g;
+
+        // 1 -> 2 -> 3 -> 1 weighs -1, and isn't reachable from 4
+        const auto cycle = new Graph(5, true);
+        cycle->addEdge(0, 1, 2);
+        cycle->addEdge(1, 2, 1);
+        cycle->addEdge(2, 3, -4);
+        cycle->addEdge(3, 1, 2);
+        cycle->addEdge(4, 0, 1);
+        for (const int src: {0, 4}) {
+            CHECK_THROWS_AS(Algorithms::bellmanFord(cycle, src), std::domain_error);
+            CHECK_THROWS_AS(Algorithms::bellmanFordParallel(cycle, src, 3), std::domain_error);
+        }
+        cycle->deleteEdge(4, 0);
+        const auto alone = Algorithms::bellmanFordParallel(cycle, 4);
+        CHECK_EQ(alone->dist[4], 0);
+        CHECK(!alone->reached(1));
+        delete alone;
+        delete cycle;
+
+        const auto undirected = new Graph(3);
+        undirected->addEdge(0, 1, 5);
+        undirected->addEdge(1, 2, -1);
+        CHECK_THROWS_AS(Algorithms::bellmanFord(undirected, 0), std::domain_error);
+        CHECK_THROWS_AS(Algorithms::bellmanFordParallel(undirected, 0), std::domain_error);
+        delete undirected;
+
+        // 0 -> 1 -> 2 sums past INT_MAX: it must not wrap into a shortcut back to 1 (a fake negative cycle)
+        const auto heavy = new Graph(3, true);
+        heavy->addEdge(0, 1, INT_MAX - 5);
+        heavy->addEdge(1, 2, INT_MAX - 5);
+        heavy->addEdge(2, 1, INT_MAX - 5);
+        for (const auto tree: {Algorithms::bellmanFord(heavy, 0), Algorithms::bellmanFordParallel(heavy, 0, 2)}) {
+            CHECK_EQ(tree->dist[1], INT_MAX - 5);
+            CHECK(!tree->reached(2));
+            delete tree;
+        }
+        delete heavy;
+    }
+
+    TEST_CASE("Landmarks") {
+        cout << endl << "Testing ALT landmarks" << endl;
+
+        for (const bool directed: {false, true}) {
+            const auto g = random_graph(80, 200, directed, directed ? 5 : 6);
+            const Landmarks alt(g, 4);
+            CHECK_EQ(alt.k, 4);
+            for (int i = 1; i < alt.k; i++) CHECK_NE(alt.landmarks[i], alt.landmarks[0]);
+
+            for (int src = 0; src < g->n; src += 9) {
+                const auto tree = Algorithms::djikstraTree(g, src);
+                for (int dst = 0; dst < g->n; dst++) {
+                    if (tree->reached(dst)) {
+                        CHECK(alt.lowerBound(src, dst) <= tree->dist[dst]);
+                        CHECK(alt.upperBound(src, dst) >= tree->dist[dst]);
+                    }
+                    const auto path = Algorithms::astar(g, src, dst, alt);
+                    CHECK_EQ(path->dist, tree->dist[dst]);
+                    delete path;
+                }
+                delete tree;
+            }
+            delete g;
+        }
+
+        const auto g = new Graph(3);
+        CHECK_THROWS(Landmarks(g, 0));
+        CHECK_THROWS(Landmarks(g, 4));
+        CHECK_THROWS(Landmarks(static_cast<const Graph *>(nullptr), 1));
+        delete g;
+
+        // through landmark 1, 0 -> 2 sums past INT_MAX: no bound rather than a wrapped one
+        const auto heavy = new Graph(3, true);
+        heavy->addEdge(0, 1, INT_MAX - 5);
+        heavy->addEdge(1, 2, INT_MAX - 5);
+        const Landmarks heavy_alt(heavy, 3);
+        CHECK_EQ(heavy_alt.upperBound(0, 1), INT_MAX - 5);
+        CHECK_EQ(heavy_alt.upperBound(0, 2), Graph::VtxDist::INF);
+        delete heavy;
+    }
+
+    TEST_CASE("Contraction hierarchies") {
+        cout << endl << "Testing contraction hierarchies" << endl;
+
+        for (const bool directed: {false, true}) {
+            const auto g = random_graph(120, 300, directed, directed ? 11 : 12);
+            const CSRGraph csr(g);
+            const ContractionHierarchy ch(g), ch_csr(csr);
+            CHECK_EQ(ch.shortcuts, ch_csr.shortcuts);
+            CHECK(ch.augmented->m() >= g->m());
+
+            // ranks are a permutation
+            Bitmap ranked(g->n);
+            for (int v = 0; v < g->n; v++) ranked.set(ch.rank[v]);
+            for (int r = 0; r < g->n; r++) CHECK(ranked.get(r));
+
+            for (int src = 0; src < g->n; src += 11) {
+                const auto tree = Algorithms::djikstraTree(g, src);
+                for (int dst = 0; dst < g->n; dst++) {
+                    const auto path = ch.query(src, dst);
+                    CHECK_EQ(path->dist, tree->dist[dst]);
+                    // unpacked into original edges
+                    if (path->found()) CHECK_EQ(path_weight(g, path), path->dist);
+                    delete path;
+                }
+                delete tree;
+            }
+            CHECK_THROWS(ch.query(0, g->n));
+            delete g;
+        }
+
+        // 0's zero weight cluster exhausts witness searches from 0 before they reach 2 (directly, or 0-1-2)
+        for (const bool directed: {false, true}) {
+            const auto star = new Graph(2003, directed);
+            star->addEdge(0, 1, 5);
+            star->addEdge(1, 2, 5);
+            star->addEdge(0, 2, 6);
+            for (int v = 3; v < star->n; v++) star->addEdge(0, v, 0);
+            const ContractionHierarchy ch(star);
+            for (const int src: {0, 1, 2, 3}) {
+                const auto tree = Algorithms::djikstraTree(star, src);
+                for (const int dst: {0, 1, 2, 3, 2002}) {
+                    const auto path = ch.query(src, dst);
+                    CHECK_EQ(path->dist, tree->dist[dst]);
+                    if (path->found()) CHECK_EQ(path_weight(star, path), path->dist);
+                    delete path;
+                }
+                delete tree;
+            }
+            delete star;
+        }
+
+        // contracting 1 would need a 0 -> 2 shortcut past INT_MAX, which is no path at all
+        const auto heavy = new Graph(3, true);
+        heavy->addEdge(0, 1, INT_MAX - 5);
+        heavy->addEdge(1, 2, INT_MAX - 5);
+        const ContractionHierarchy heavy_ch(heavy);
+        const auto near = heavy_ch.query(0, 1), far = heavy_ch.query(0, 2);
+        CHECK_EQ(near->dist, INT_MAX - 5);
+        CHECK(!far->found());
+        delete near;
+        delete far;
+        delete heavy;
+
+        const auto neg = new Graph(2);
+        neg->addEdge(0, 1, -1);
+        CHECK_THROWS(ContractionHierarchy(neg).query(0, 1));
+        delete neg;
     }
 
     TEST_CASE("Graph") {
@@ -125,6 +1045,22 @@ TEST_SUITE("algorithms") {
             delete bfs;
         }
 
+        SUBCASE("BFS Tree") {
+            cout << "BFS parent/depth arrays" << endl;
+            const auto tree = Algorithms::bfsTree(g, src);
+
+            CHECK_EQ(tree->src, src);
+            CHECK_EQ(tree->parent[src], -1);
+            CHECK_EQ(tree->dist[src], 0);
+            CHECK_EQ(tree->parent[1], 3);
+            CHECK_EQ(tree->parent[5], 0);
+            CHECK_EQ(tree->dist[5], 2);
+            for (int v = 0; v < g->n; v++)
+                CHECK(tree->reached(v));
+
+            delete tree;
+        }
+
         SUBCASE("DFS") {
             cout << "DFS" << endl;
             const auto dfs_forest = Algorithms::dfs(g, 0);
@@ -187,6 +1123,30 @@ TEST_SUITE("algorithms") {
 
             delete djikstra;
 
+            SUBCASE("Unreachable") {
+                auto split = new Graph(4);
+                split->addEdge(0, 1, 2);
+                split->addEdge(2, 3, 1);
+                const auto sp = Algorithms::djikstra(split, 0);
+                CHECK_EQ(sp->weight(0, 1), 2);
+                CHECK_EQ(sp->weight(0, 2), Graph::VtxDist::INF);
+                CHECK_EQ(sp->weight(0, 3), Graph::VtxDist::INF);
+                delete sp;
+                delete split;
+            }
+
+            SUBCASE("Heavy weights") {
+                // 0 -> 2 sums past INT_MAX, it must stay unreached rather than wrap around negative
+                auto heavy = new Graph(3, true);
+                heavy->addEdge(0, 1, INT_MAX - 5);
+                heavy->addEdge(1, 2, INT_MAX - 5);
+                const auto sp = Algorithms::djikstra(heavy, 0);
+                CHECK_EQ(sp->weight(0, 1), INT_MAX - 5);
+                CHECK_EQ(sp->weight(0, 2), Graph::VtxDist::INF);
+                delete sp;
+                delete heavy;
+            }
+
             SUBCASE("Negative weights") {
                 cout << "Testing negative weights (should be unsupported)" << endl;
                 // djikstra on negative weight is unsupported
@@ -199,6 +1159,41 @@ TEST_SUITE("algorithms") {
             }
         }
 
+        SUBCASE("CSR") {
+            cout << "CSR representation" << endl;
+            const CSRGraph csr(g);
+
+            CHECK_EQ(csr.n, g->n);
+            CHECK_EQ(csr.m(), g->m());
+            CHECK_EQ(csr.weight(), g->weight());
+            for (int u = 0; u < g->n; u++)
+                CHECK_EQ(csr.degree(u), g->neighbour_list[u].length());
+
+            // algorithms run on csr exactly as they do on the adjacency list
+            const auto bfs = Algorithms::bfs(csr, src);
+            CHECK_EQ(bfs->m(), g->n-1);
+            CHECK(bfs->hasEdge(3,1));
+            CHECK(bfs->hasEdge(0,5));
+            delete bfs;
+
+            const auto djikstra = Algorithms::djikstra(csr, src);
+            CHECK_EQ(djikstra->weight(src, 1), 2);
+            CHECK_EQ(djikstra->weight(src, 5), 1);
+            delete djikstra;
+
+            const auto mst_p = Algorithms::prim(csr, src), mst_k = Algorithms::kruskal(csr);
+            CHECK_EQ(mst_p->weight(), expected_mst_cost);
+            CHECK_EQ(mst_k->weight(), expected_mst_cost);
+            delete mst_p;
+            delete mst_k;
+
+            const auto dfs_forest = Algorithms::dfs(csr, 0);
+            CHECK_EQ(dfs_forest[0]->m(), g->n-1);
+            for (int v = 0; v<g->n; v++)
+                delete dfs_forest[v];
+            delete[] dfs_forest;
+        }
+
         SUBCASE("Prim") {
             cout << "Prim MST (Edge Cut) from (" << src << ")" << endl;
             const auto mst_p = Algorithms::prim(g, src);
@@ -206,7 +1201,15 @@ TEST_SUITE("algorithms") {
             const auto cost = mst_p->weight();
             CHECK_EQ(cost, expected_mst_cost);
             cout << "cost: " << cost << endl;
+            CHECK_EQ(mst_p->m(), g->n - 1);
             delete mst_p;
+
+            // not connected from src
+            auto split = new Graph(4);
+            split->addEdge(0, 1);
+            split->addEdge(2, 3);
+            CHECK_THROWS(Algorithms::prim(split, 0));
+            delete split;
         }
 
 
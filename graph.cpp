@@ -4,22 +4,29 @@
 
 #include "graph.h"
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <stdexcept>
+#include <thread>
 
 using namespace ds;
 
 namespace graphs {
     /* Graph */
 
-    void Graph::VtxDist::relax(const int d) {
-        if ((weight == INF && d != INF) || weight > d) weight = d;
+    bool Graph::VtxDist::relax(const long long d) {
+        if (d >= weight) return false;
+        weight = static_cast<int>(d);
+        return true;
     }
 
     Graph::Graph(const int n, const bool directed) : n(n), directed(directed) {
         if (n < 0) throw std::invalid_argument("n must be positive");
 
+        links = new SlabPool<LinkedList<Edge>::Link<Edge> >();
         neighbour_list = new LinkedList<Edge>[n];
+        for (int u = 0; u < n; u++) neighbour_list[u].setPool(links);
     }
 
     Graph::Graph(const Graph *copy, const bool copy_edges): Graph(copy->n, copy->directed) {
@@ -28,6 +35,59 @@ namespace graphs {
                 neighbour_list[i].addLast(&copy->neighbour_list[i]);
     }
 
+    Graph *Graph::fromEdges(const int n, const bool directed, const WeightedEdge *edges, const int count) {
+        const auto graph = new Graph(n, directed);
+        auto sorted = new WeightedEdge[count], buffer = new WeightedEdge[count];
+        int len = 0;
+        for (int i = 0; i < count; i++) {
+            auto e = edges[i];
+            if (!graph->hasVtx(e.u) || !graph->hasVtx(e.v)) {
+                delete[] sorted;
+                delete[] buffer;
+                delete graph;
+                throw std::invalid_argument("edge " + std::to_string(e.u) + "->" + std::to_string(e.v) +
+                                            " has a node that doesn't exist");
+            }
+            if (e.u == e.v) continue;
+            if (!directed && e.u > e.v) {
+                // undirected edges are keyed once, under (min, max)
+                const int tmp = e.u;
+                e.u = e.v;
+                e.v = tmp;
+            }
+            sorted[len++] = e;
+        }
+
+        // LSD radix sort, a stable counting sort pass by v and then by u. Stable keeps input order among repeats.
+        const auto count_sort = [&](int WeightedEdge::*key) {
+            const auto at = new int[n + 1]();
+            for (int i = 0; i < len; i++) at[sorted[i].*key + 1]++;
+            for (int k = 0; k < n; k++) at[k + 1] += at[k];
+            for (int i = 0; i < len; i++) buffer[at[sorted[i].*key]++] = sorted[i];
+            delete[] at;
+            const auto tmp = sorted;
+            sorted = buffer;
+            buffer = tmp;
+        };
+        count_sort(&WeightedEdge::v);
+        count_sort(&WeightedEdge::u);
+
+        for (int i = 0; i < len; i++) {
+            const auto &e = sorted[i];
+            if (i > 0 && sorted[i - 1].u == e.u && sorted[i - 1].v == e.v) continue; // repeat
+            graph->neighbour_list[e.u].addLast(Edge(e.v, e.weight));
+            graph->e++;
+            if (!directed) {
+                graph->neighbour_list[e.v].addLast(Edge(e.u, e.weight));
+                graph->e++;
+            }
+        }
+
+        delete[] sorted;
+        delete[] buffer;
+        return graph;
+    }
+
     int Graph::m() const {
         return static_cast<int>(static_cast<float>(e) * (directed ? 1 : .5f));
     }
@@ -40,6 +100,7 @@ namespace graphs {
         if (hasEdge(u, v)) return;
 
         neighbour_list[u].addLast(Edge(v, weight)); // u -> v
+        if (edge_index) edge_index->put(edgeKey(u, v), weight);
         e++;
         if (!directed) {
             e++;
@@ -54,6 +115,7 @@ namespace graphs {
         if (!hasEdge(u, v)) return;
 
         neighbour_list[u].removeValue(v);
+        if (edge_index) edge_index->remove(edgeKey(u, v));
         e--;
         if (!directed) {
             neighbour_list[v].removeValue(u);
@@ -66,6 +128,7 @@ namespace graphs {
         assert_graph_vtx(this, v);
 
         if (u == v) return true;
+        if (edge_index) return edge_index->contains(edgeKey(u, v));
 
         return neighbour_list[u].contains(Edge(v)) || (!directed && neighbour_list[v].contains(Edge(u)));
     }
@@ -74,11 +137,33 @@ namespace graphs {
         return 0 <= u && u < n;
     }
 
+    unsigned long long Graph::edgeKey(int u, int v) const {
+        // undirected edges are stored once, under (min, max)
+        if (!directed && u > v) {
+            const int tmp = u;
+            u = v;
+            v = tmp;
+        }
+        return static_cast<unsigned long long>(u) << 32 | static_cast<unsigned>(v);
+    }
+
+    void Graph::buildEdgeIndex() {
+        if (edge_index) return;
+        edge_index = new HashIndex(m());
+        for (int u = 0; u < n; u++)
+            for (auto it = neighbours(u); !it.done(); it.next())
+                edge_index->put(edgeKey(u, it.vertex()), it.weight());
+    }
+
     int Graph::weight(const int u, const int v) const {
         assert_graph_vtx(this, u);
         assert_graph_vtx(this, v);
 
         if (u == v) return 0;
+        if (edge_index) {
+            if (const auto w = edge_index->find(edgeKey(u, v))) return *w;
+            throw std::out_of_range("No such edge " + std::to_string(u) + "->" + std::to_string(v));
+        }
         if (!hasEdge(u, v)) throw std::out_of_range("No such edge " + std::to_string(u) + "->" + std::to_string(v));
 
         auto neighbour = neighbour_list[u].head;
@@ -119,218 +204,2001 @@ namespace graphs {
         std::cout << *this;
     }
 
+    /* CSR Graph */
+
+    CSRGraph::CSRGraph(const Graph *graph) : n(graph->n), directed(graph->directed) {
+        offsets = new int[n + 1];
+        offsets[0] = 0;
+        for (int u = 0; u < n; u++)
+            offsets[u + 1] = offsets[u] + graph->neighbour_list[u].length();
+
+        targets = new int[offsets[n]];
+        weights = new int[offsets[n]];
+        for (int u = 0; u < n; u++) {
+            int i = offsets[u];
+            for (auto it = graph->neighbours(u); !it.done(); it.next(), i++) {
+                targets[i] = it.vertex();
+                weights[i] = it.weight();
+            }
+        }
+    }
+
+    CSRGraph::CSRGraph(const int n, const bool directed, int *offsets, int *targets, int *weights)
+        : n(n), directed(directed), offsets(offsets), targets(targets), weights(weights) {
+    }
+
+    template<class G>
+    CSRGraph *CSRGraph::transpose(const G *graph) {
+        const int n = graph->n;
+        const auto offsets = new int[n + 1]();
+        for (int u = 0; u < n; u++)
+            for (auto it = graph->neighbours(u); !it.done(); it.next())
+                offsets[it.vertex() + 1]++;
+        for (int v = 0; v < n; v++) offsets[v + 1] += offsets[v];
+
+        const auto targets = new int[offsets[n]], weights = new int[offsets[n]];
+        const auto fill = new int[n];
+        for (int v = 0; v < n; v++) fill[v] = offsets[v];
+        for (int u = 0; u < n; u++)
+            for (auto it = graph->neighbours(u); !it.done(); it.next()) {
+                const int i = fill[it.vertex()]++;
+                targets[i] = u;
+                weights[i] = it.weight();
+            }
+        delete[] fill;
+
+        return new CSRGraph(n, graph->directed, offsets, targets, weights);
+    }
+
+    template CSRGraph *CSRGraph::transpose(const Graph *graph);
+
+    template CSRGraph *CSRGraph::transpose(const CSRGraph *graph);
+
+    int CSRGraph::m() const {
+        return directed ? offsets[n] : offsets[n] / 2;
+    }
+
+    bool CSRGraph::hasVtx(const int u) const {
+        return 0 <= u && u < n;
+    }
+
+    int CSRGraph::weight() const {
+        int sum = 0;
+        for (int i = 0; i < offsets[n]; i++) sum += weights[i];
+        return static_cast<int>(static_cast<float>(sum) * (directed ? 1 : .5f));
+    }
+
+    bool CSRGraph::hasNegativeWeights() const {
+        for (int i = 0; i < offsets[n]; i++)
+            if (weights[i] < 0)
+                return true;
+        return false;
+    }
+
+    /* Path Tree */
+
+    PathTree::PathTree(const int n, const int src) : n(n), src(src) {
+        parent = new int[n];
+        dist = new int[n];
+        for (int v = 0; v < n; v++) {
+            parent[v] = -1;
+            dist[v] = Graph::VtxDist::INF;
+        }
+    }
+
+    Path *PathTree::pathTo(const int v) const {
+        const auto path = new Path(src, v);
+        if (!reached(v)) return path;
+        path->dist = dist[v];
+        for (int u = v; u != -1; u = parent[u]) path->length++;
+        path->vertices = new int[path->length];
+        int i = path->length;
+        for (int u = v; u != -1; u = parent[u]) path->vertices[--i] = u;
+        return path;
+    }
+
+    /* DFS Forest */
+
+    DFSForest::DFSForest(const int n, const bool directed) : n(n), directed(directed) {
+        parent = new int[n];
+        tree = new int[n];
+        discovery = new int[n];
+        finish = new int[n];
+        for (int v = 0; v < n; v++) parent[v] = -1;
+    }
+
+    Graph *DFSForest::toGraph(const int t) const {
+        if (t < 0 || t >= trees) throw std::out_of_range("No such tree " + std::to_string(t));
+        const auto edges = new Graph::WeightedEdge[n];
+        int count = 0;
+        for (int v = 0; v < n; v++)
+            if (tree[v] == t && parent[v] != -1)
+                edges[count++] = Graph::WeightedEdge(parent[v], v);
+        const auto result = Graph::fromEdges(n, directed, edges, count);
+        delete[] edges;
+        return result;
+    }
+
+    /* Components */
+
+    Components::Components(const int n, const int *representative) : n(n) {
+        id = new int[n];
+        const auto label = new int[n];
+        for (int v = 0; v < n; v++) label[v] = -1;
+        for (int v = 0; v < n; v++) {
+            int &c = label[representative[v]];
+            if (c == -1) c = count++;
+            id[v] = c;
+        }
+        delete[] label;
+
+        size = new int[count]();
+        for (int v = 0; v < n; v++) size[id[v]]++;
+    }
+
     /* Algorithms */
 
-    Graph *Algorithms::bfs(const Graph *graph, const int src) {
+    template<class G>
+    PathTree *Algorithms::bfs_tree_impl(const G *graph, const int src) {
         assert_graph(graph);
         assert_graph_vtx(graph, src);
 
-        const auto result = new Graph(graph, false);
-        Queue<int> gray, marked;
+        const auto tree = new PathTree(graph->n, src);
+        // every node is discovered (and so enqueued) at most once, so n slots are enough.
+        Bitmap discovered(graph->n);
+        RingQueue<int> frontier(graph->n);
+
+        discovered.set(src);
+        tree->dist[src] = 0;
+        frontier.insert(src);
+        while (!frontier.isEmpty()) {
+            const auto u = frontier.pop();
+            for (auto neighbour = graph->neighbours(u); !neighbour.done(); neighbour.next()) {
+                if (const auto v = neighbour.vertex(); !discovered.get(v)) {
+                    discovered.set(v);
+                    tree->parent[v] = u;
+                    tree->dist[v] = tree->dist[u] + 1;
+                    frontier.insert(v);
+                }
+            }
+        }
 
-        gray.insert(src);
-        while (!gray.isEmpty()) {
-            if (const auto u = gray.pop(); !marked.contains(u)) {
-                marked.insert(u);
+        return tree;
+    }
 
-                auto neighbour = graph->neighbour_list[u].head;
-                while (neighbour) {
-                    if (const auto v = neighbour->val.vertex; !marked.contains(v) && !gray.contains(v)) {
-                        gray.insert(neighbour->val.vertex);
-                        result->addEdge(u, v);
+    template<class G>
+    Graph *Algorithms::bfs_impl(const G *graph, const int src) {
+        const auto tree = bfs_tree_impl(graph, src);
+        // tree edges parent->v
+        const auto edges = new Graph::WeightedEdge[graph->n];
+        int count = 0;
+        for (int v = 0; v < graph->n; v++)
+            if (tree->parent[v] != -1)
+                edges[count++] = Graph::WeightedEdge(tree->parent[v], v);
+        const auto result = Graph::fromEdges(graph->n, graph->directed, edges, count);
+        delete[] edges;
+        delete tree;
+        return result;
+    }
+
+    template<class G, class R>
+    PathTree *Algorithms::bfs_hybrid_impl(const G *graph, const R *incoming, const int src,
+                                          const int alpha, const int beta) {
+        const int n = graph->n;
+        const auto tree = new PathTree(n, src);
+        auto frontier = new int[n], next = new int[n];
+        int f_len = 0;
+        Bitmap in_frontier(n);
+
+        // m_f: edges to check from the frontier, m_u: edges to check from unexplored nodes
+        long long m_f = graph->degree(src), m_u = -m_f;
+        for (int v = 0; v < n; v++) m_u += graph->degree(v);
+
+        tree->dist[src] = 0;
+        frontier[f_len++] = src;
+        bool bottom_up = false;
+        for (int depth = 0; f_len > 0; depth++) {
+            if (!bottom_up && m_f * alpha > m_u) bottom_up = true;
+            else if (bottom_up && f_len * beta < n) bottom_up = false;
+
+            int next_len = 0;
+            long long next_m_f = 0;
+            if (bottom_up) {
+                in_frontier.clear();
+                for (int i = 0; i < f_len; i++) in_frontier.set(frontier[i]);
+                // every unreached node looks for any parent in the frontier, and stops at the first one
+                for (int v = 0; v < n; v++) {
+                    if (tree->reached(v)) continue;
+                    for (auto neighbour = incoming->neighbours(v); !neighbour.done(); neighbour.next()) {
+                        if (const auto u = neighbour.vertex(); in_frontier.get(u)) {
+                            tree->parent[v] = u;
+                            tree->dist[v] = depth + 1;
+                            next[next_len++] = v;
+                            next_m_f += graph->degree(v);
+                            break;
+                        }
                     }
-                    neighbour = neighbour->next;
+                }
+            } else {
+                for (int i = 0; i < f_len; i++) {
+                    const auto u = frontier[i];
+                    for (auto neighbour = graph->neighbours(u); !neighbour.done(); neighbour.next()) {
+                        if (const auto v = neighbour.vertex(); !tree->reached(v)) {
+                            tree->parent[v] = u;
+                            tree->dist[v] = depth + 1;
+                            next[next_len++] = v;
+                            next_m_f += graph->degree(v);
+                        }
+                    }
+                }
+            }
+
+            m_u -= next_m_f;
+            m_f = next_m_f;
+            const auto tmp = frontier;
+            frontier = next;
+            next = tmp;
+            f_len = next_len;
+        }
+
+        delete[] frontier;
+        delete[] next;
+        return tree;
+    }
+
+    int Algorithms::thread_count(const int threads) {
+        if (threads < 0) throw std::invalid_argument("thread count can't be negative");
+        if (threads > 0) return threads;
+        const int hw = static_cast<int>(std::thread::hardware_concurrency());
+        return hw > 0 ? hw : 1;
+    }
+
+    template<class F>
+    void Algorithms::run_threads(const int threads, const F &work) {
+        const auto pool = new std::thread[threads - 1];
+        for (int i = 1; i < threads; i++) pool[i - 1] = std::thread(work, i);
+        work(0);
+        for (int i = 0; i < threads - 1; i++) pool[i].join();
+        delete[] pool;
+    }
+
+    long long Algorithms::pack_dist(const long long dist, const int parent) {
+        return static_cast<long long>(static_cast<unsigned long long>(dist) << 32 | static_cast<unsigned>(parent));
+    }
+
+    PathTree *Algorithms::unpack_dists(const std::atomic<long long> *state, const int n, const int src) {
+        const auto tree = new PathTree(n, src);
+        for (int v = 0; v < n; v++) {
+            const long long packed = state[v].load();
+            tree->dist[v] = static_cast<int>(packed >> 32);
+            tree->parent[v] = static_cast<int>(static_cast<unsigned>(packed));
+        }
+        return tree;
+    }
+
+    template<class G>
+    PathTree *Algorithms::bfs_parallel_impl(const G *graph, const int src, const int threads) {
+        assert_graph(graph);
+        assert_graph_vtx(graph, src);
+        const int n = graph->n, t = thread_count(threads);
+        constexpr int CHUNK = 64; // frontier nodes a thread claims at once
+
+        const auto tree = new PathTree(n, src);
+        const auto parent = new std::atomic<int>[n];
+        for (int v = 0; v < n; v++) parent[v].store(-1, std::memory_order_relaxed);
+        parent[src] = src; // claimed, reset to -1 at the end
+
+        auto frontier = new int[n], next = new int[n];
+        int f_len = 1, depth = 0;
+        frontier[0] = src;
+        tree->dist[src] = 0;
+        std::atomic<int> cursor(0), next_len(0);
+
+        // runs once per level by the last thread to finish it
+        Barrier level_done(t, [&] {
+            const auto tmp = frontier;
+            frontier = next;
+            next = tmp;
+            f_len = next_len.load();
+            next_len = 0;
+            cursor = 0;
+            depth++;
+        });
+
+        const auto worker = [&] {
+            // thread local next level, grows as needed (a full n sized buffer per thread would be O(threads * n))
+            ArrayList<int> local;
+            while (f_len > 0) {
+                local.clear();
+                for (int begin; (begin = cursor.fetch_add(CHUNK)) < f_len;) {
+                    const int end = begin + CHUNK < f_len ? begin + CHUNK : f_len;
+                    for (int i = begin; i < end; i++) {
+                        const auto u = frontier[i];
+                        for (auto neighbour = graph->neighbours(u); !neighbour.done(); neighbour.next()) {
+                            const auto v = neighbour.vertex();
+                            int unclaimed = -1;
+                            if (parent[v].load(std::memory_order_relaxed) == -1 &&
+                                parent[v].compare_exchange_strong(unclaimed, u)) {
+                                tree->dist[v] = depth + 1;
+                                local.add(v);
+                            }
+                        }
+                    }
+                }
+                // flush thread local next level
+                const int at = next_len.fetch_add(local.size());
+                for (int i = 0; i < local.size(); i++) next[at + i] = local[i];
+                level_done.wait();
+            }
+        };
+
+        run_threads(t, [&](int) { worker(); });
+
+        for (int v = 0; v < n; v++) tree->parent[v] = v == src ? -1 : parent[v].load();
+        delete[] parent;
+        delete[] frontier;
+        delete[] next;
+        return tree;
+    }
+
+    template<class G>
+    DFSForest *Algorithms::dfs_forest_impl(const G *graph, const int src) {
+        assert_graph(graph);
+        assert_graph_vtx(graph, src);
+        const int n = graph->n;
+
+        const auto forest = new DFSForest(n, graph->directed);
+        Bitmap visited(n);
+        // every node is on the stack at most once
+        struct Frame {
+            int u;
+            typename G::NeighbourIterator neighbour;
+        };
+        const auto stack = static_cast<Frame *>(::operator new(sizeof(Frame) * n));
+        int top = 0, time = 0;
+
+        // start forest creation from src, in case of overflow loop back to 0 node
+        for (int i = 0; i < n; i++) {
+            const int root = (src + i) % n;
+            if (visited.get(root)) continue;
+
+            const int t = forest->trees++;
+            visited.set(root);
+            forest->tree[root] = t;
+            forest->discovery[root] = time++;
+            new(&stack[top++]) Frame{root, graph->neighbours(root)};
+            while (top > 0) {
+                auto &frame = stack[top - 1];
+                if (frame.neighbour.done()) {
+                    // all of u's neighbours are explored
+                    forest->finish[frame.u] = time++;
+                    stack[--top].~Frame();
+                    continue;
+                }
+                const auto v = frame.neighbour.vertex();
+                frame.neighbour.next(); // resume from the next neighbour when we get back to u
+                if (!visited.get(v)) {
+                    visited.set(v);
+                    forest->parent[v] = frame.u;
+                    forest->tree[v] = t;
+                    forest->discovery[v] = time++;
+                    new(&stack[top++]) Frame{v, graph->neighbours(v)};
                 }
             }
         }
 
+        ::operator delete(stack);
+        return forest;
+    }
+
+    template<class G>
+    Graph **Algorithms::dfs_impl(const G *graph, const int src) {
+        const auto forest = dfs_forest_impl(graph, src);
+        const int n = graph->n;
+
+        const auto result = new Graph *[n];
+        for (int i = 0; i < n; ++i) result[i] = nullptr;
+
+        // tree edges grouped by tree (counting sort), then each tree's graph is built from its slice
+        const auto at = new int[forest->trees + 1](), fill = new int[forest->trees];
+        for (int v = 0; v < n; v++)
+            if (forest->parent[v] != -1) at[forest->tree[v] + 1]++;
+        for (int t = 0; t < forest->trees; t++) {
+            at[t + 1] += at[t];
+            fill[t] = at[t];
+        }
+        const auto edges = new Graph::WeightedEdge[n];
+        for (int v = 0; v < n; v++)
+            if (const int p = forest->parent[v]; p != -1)
+                edges[fill[forest->tree[v]]++] = Graph::WeightedEdge(p, v);
+        for (int v = 0; v < n; v++)
+            if (forest->parent[v] == -1) {
+                const int t = forest->tree[v];
+                result[v] = Graph::fromEdges(n, graph->directed, edges + at[t], at[t + 1] - at[t]);
+            }
+
+        delete[] edges;
+        delete[] at;
+        delete[] fill;
+        delete forest;
         return result;
     }
 
-    void Algorithms::dfs_recursive(const Graph *graph, const int u, Graph *result, bool *visited) {
-        visited[u] = true;
-        auto neighbour = graph->neighbour_list[u].head;
-        while (neighbour) {
-            const auto v = neighbour->val.vertex;
-            if (!visited[v]) {
-                result->addEdge(u, v);
-                dfs_recursive(graph, v, result, visited);
+    template<class G>
+    Components *Algorithms::components_impl(const G *graph) {
+        assert_graph(graph);
+        const int n = graph->n;
+
+        UnionSet vertexes(n);
+        for (int u = 0; u < n; u++)
+            for (auto neighbour = graph->neighbours(u); !neighbour.done(); neighbour.next())
+                vertexes.unite(u, neighbour.vertex());
+
+        const auto root = new int[n];
+        for (int v = 0; v < n; v++) root[v] = vertexes.find(v);
+        const auto components = new Components(n, root);
+        delete[] root;
+        return components;
+    }
+
+    template<class G>
+    Components *Algorithms::components_parallel_impl(const G *graph, const int threads) {
+        assert_graph(graph);
+        const int n = graph->n, t = thread_count(threads);
+        constexpr int NEIGHBOUR_ROUNDS = 2, SAMPLES = 1024;
+
+        ConcurrentUnionSet vertexes(n);
+        const auto root = new int[n];
+
+        // link every node with its first few neighbours, which usually already forms most of the giant component
+        run_threads(t, [&](const int thread) {
+            for (int u = thread; u < n; u += t) {
+                int i = 0;
+                for (auto neighbour = graph->neighbours(u); !neighbour.done() && i < NEIGHBOUR_ROUNDS;
+                     neighbour.next(), i++)
+                    vertexes.unite(u, neighbour.vertex());
             }
-            neighbour = neighbour->next;
+        });
+
+        // sample the most frequent component
+        int giant = -1;
+        if (!graph->directed) {
+            const auto sampled = new int[SAMPLES];
+            unsigned seed = 1;
+            for (int i = 0; i < SAMPLES; i++) {
+                seed = seed * 1103515245 + 12345;
+                sampled[i] = vertexes.find(static_cast<int>((seed >> 8) % n));
+            }
+            std::sort(sampled, sampled + SAMPLES);
+            for (int i = 0, best = 0; i < SAMPLES;) {
+                int j = i;
+                while (j < SAMPLES && sampled[j] == sampled[i]) j++;
+                if (j - i > best) best = j - i, giant = sampled[i];
+                i = j;
+            }
+            delete[] sampled;
         }
+        // ...and finish the rest of the edges. nodes already in the giant component can be skipped:
+        // their remaining edges lead either into it or to nodes that will link to it from their own side.
+        // (that's only true when every edge is seen from both ends, so directed graphs skip nothing)
+        run_threads(t, [&](const int thread) {
+            for (int u = thread; u < n; u += t) {
+                if (giant != -1 && vertexes.find(u) == vertexes.find(giant)) continue;
+                int i = 0;
+                for (auto neighbour = graph->neighbours(u); !neighbour.done(); neighbour.next(), i++)
+                    if (i >= NEIGHBOUR_ROUNDS)
+                        vertexes.unite(u, neighbour.vertex());
+            }
+        });
+
+        run_threads(t, [&](const int thread) {
+            for (int v = thread; v < n; v += t) root[v] = vertexes.find(v);
+        });
+        const auto components = new Components(n, root);
+        delete[] root;
+        return components;
     }
 
-    Graph **Algorithms::dfs(const Graph *graph, const int src) {
+    template<class G>
+    Components *Algorithms::scc_impl(const G *graph) {
         assert_graph(graph);
+        const int n = graph->n;
 
-        bool visited[graph->n] = {false};
-        const auto result = new Graph *[graph->n];
-        for (int i = 0; i < graph->n; ++i) result[i] = nullptr;
+        // tarjan: index[v] is v's visit order, low[v] the smallest index v's subtree reaches back to
+        const auto index = new int[n], low = new int[n], component = new int[n], open = new int[n];
+        for (int v = 0; v < n; v++) index[v] = -1;
+        Bitmap on_open(n);
+        struct Frame {
+            int u;
+            typename G::NeighbourIterator neighbour;
+        };
+        const auto stack = static_cast<Frame *>(::operator new(sizeof(Frame) * n));
+        int top = 0, open_top = 0, time = 0, count = 0;
 
-        // start forest creation from src
-        for (int v = src; v < graph->n && !visited[v]; v++) {
-            if (v >= graph->n) v = 0; // in case of overflow loop back to 0 node
+        const auto enter = [&](const int v) {
+            index[v] = low[v] = time++;
+            open[open_top++] = v;
+            on_open.set(v);
+            new(&stack[top++]) Frame{v, graph->neighbours(v)};
+        };
 
-            result[v] = new Graph(graph, false);
-            dfs_recursive(graph, v, result[v], visited);
+        for (int root = 0; root < n; root++) {
+            if (index[root] != -1) continue;
+            enter(root);
+            while (top > 0) {
+                auto &frame = stack[top - 1];
+                const int u = frame.u;
+                if (!frame.neighbour.done()) {
+                    const auto v = frame.neighbour.vertex();
+                    frame.neighbour.next();
+                    if (index[v] == -1) enter(v);
+                    else if (on_open.get(v) && index[v] < low[u]) low[u] = index[v];
+                    continue;
+                }
+                // u is done. if it's a component root, everything opened after it is its component
+                stack[--top].~Frame();
+                if (low[u] == index[u]) {
+                    int v;
+                    do {
+                        v = open[--open_top];
+                        on_open.unset(v);
+                        component[v] = count;
+                    } while (v != u);
+                    count++;
+                }
+                if (top > 0 && low[u] < low[stack[top - 1].u]) low[stack[top - 1].u] = low[u];
+            }
         }
 
-        return result;
+        ::operator delete(stack);
+        const auto components = new Components(n, component);
+        delete[] index;
+        delete[] low;
+        delete[] component;
+        delete[] open;
+        return components;
+    }
+
+    template<class G>
+    Components *Algorithms::scc_parallel_impl(const G *graph, const int threads) {
+        assert_graph(graph);
+        const int n = graph->n, t = thread_count(threads);
+        constexpr int CHUNK = 64; // frontier nodes a thread claims at once
+        const auto incoming = CSRGraph::transpose(graph);
+
+        // component[v] is the representative of v's component, -1 while v is unassigned.
+        // only written between sweeps, by the one thread finishing them.
+        const auto component = new int[n];
+        for (int v = 0; v < n; v++) component[v] = -1;
+
+        // trim: a node without incoming or outgoing edges from unassigned nodes is a singleton component.
+        // degrees only count unassigned neighbours, so every batch of assigned nodes peels what it leaves bare.
+        const auto in_degree = new int[n], out_degree = new int[n], assigned = new int[n];
+        int assigned_len = 0;
+        const auto peel = [&] {
+            for (int i = 0; i < assigned_len; i++) {
+                const int u = assigned[i];
+                for (auto neighbour = graph->neighbours(u); !neighbour.done(); neighbour.next())
+                    if (const auto v = neighbour.vertex(); component[v] == -1 && --in_degree[v] == 0)
+                        component[v] = v, assigned[assigned_len++] = v;
+                for (auto neighbour = incoming->neighbours(u); !neighbour.done(); neighbour.next())
+                    if (const auto v = neighbour.vertex(); component[v] == -1 && --out_degree[v] == 0)
+                        component[v] = v, assigned[assigned_len++] = v;
+            }
+            assigned_len = 0;
+        };
+        for (int v = 0; v < n; v++) {
+            in_degree[v] = incoming->degree(v);
+            out_degree[v] = graph->degree(v);
+            if (in_degree[v] == 0 || out_degree[v] == 0) component[v] = v, assigned[assigned_len++] = v;
+        }
+        peel();
+
+        // the unassigned nodes, compacted after every pass
+        const auto remaining = new int[n];
+        int remaining_len = 0;
+        for (int v = 0; v < n; v++)
+            if (component[v] == -1) remaining[remaining_len++] = v;
+
+        // FORWARD and BACKWARD search from one pivot, to take out the (likely giant) component in a single pass.
+        // the rest is left to COLOR, which floods the max node id reaching each node, and CLAIM, where every node
+        // that kept its own id as color collects its component backwards within its color.
+        enum Phase { FORWARD, BACKWARD, COLOR, CLAIM, DONE };
+        constexpr int REACHED = 1, REACHES = 2, CLAIMED = 4;
+        const auto mark = new std::atomic<int>[n], color = new std::atomic<int>[n];
+        // the round a node was last queued in, so COLOR queues it once per round however often it improves
+        const auto in_round = new std::atomic<long long>[n];
+        for (int v = 0; v < n; v++) {
+            mark[v].store(0, std::memory_order_relaxed);
+            in_round[v].store(-1, std::memory_order_relaxed);
+        }
+
+        auto frontier = new int[n], next = new int[n];
+        int f_len = 0, pivot = -1;
+        long long round = 0;
+        std::atomic<int> cursor(0), next_len(0);
+        Phase phase = DONE;
+        // the pivot is the node with the most paths through it, in-degree * out-degree
+        for (int i = 0; i < remaining_len; i++) {
+            const int v = remaining[i];
+            if (pivot == -1 || static_cast<long long>(in_degree[v]) * out_degree[v] >
+                               static_cast<long long>(in_degree[pivot]) * out_degree[pivot]) pivot = v;
+        }
+        if (pivot != -1) {
+            phase = FORWARD;
+            mark[pivot] = REACHED;
+            frontier[f_len++] = pivot;
+        }
+
+        const auto visit = [&](const int u, ArrayList<int> &found) {
+            if (phase == FORWARD) {
+                for (auto neighbour = graph->neighbours(u); !neighbour.done(); neighbour.next())
+                    if (const auto v = neighbour.vertex();
+                        component[v] == -1 && !(mark[v].fetch_or(REACHED) & REACHED)) found.add(v);
+            } else if (phase == BACKWARD) {
+                // pivot's component is what reaches it among what it reaches
+                for (auto neighbour = incoming->neighbours(u); !neighbour.done(); neighbour.next())
+                    if (const auto v = neighbour.vertex(); component[v] == -1 &&
+                        mark[v].load(std::memory_order_relaxed) & REACHED && !(mark[v].fetch_or(REACHES) & REACHES))
+                        found.add(v);
+            } else if (phase == COLOR) {
+                const int c = color[u].load(std::memory_order_relaxed);
+                for (auto neighbour = graph->neighbours(u); !neighbour.done(); neighbour.next()) {
+                    const auto v = neighbour.vertex();
+                    if (component[v] != -1) continue;
+                    int current = color[v].load(std::memory_order_relaxed);
+                    while (c > current && !color[v].compare_exchange_weak(current, c)) {
+                    }
+                    if (c > current && in_round[v].exchange(round) != round) found.add(v);
+                }
+            } else {
+                const int c = color[u].load(std::memory_order_relaxed);
+                for (auto neighbour = incoming->neighbours(u); !neighbour.done(); neighbour.next())
+                    if (const auto v = neighbour.vertex(); component[v] == -1 &&
+                        color[v].load(std::memory_order_relaxed) == c && !(mark[v].fetch_or(CLAIMED) & CLAIMED))
+                        found.add(v);
+            }
+        };
+
+        // a phase's sweep ran dry: assign what it found, and seed the next phase
+        const auto advance = [&] {
+            if (phase == FORWARD) {
+                phase = BACKWARD;
+                mark[pivot] |= REACHES;
+                frontier[f_len++] = pivot;
+                return;
+            }
+            if (phase == COLOR) {
+                phase = CLAIM;
+                for (int i = 0; i < remaining_len; i++)
+                    if (const int v = remaining[i]; color[v].load(std::memory_order_relaxed) == v) {
+                        mark[v] |= CLAIMED;
+                        frontier[f_len++] = v;
+                    }
+                return;
+            }
+            const int found = phase == BACKWARD ? REACHES : CLAIMED;
+            int len = 0;
+            for (int i = 0; i < remaining_len; i++) {
+                const int v = remaining[i];
+                if (component[v] == -1 && mark[v].load(std::memory_order_relaxed) & found) {
+                    component[v] = phase == BACKWARD ? pivot : color[v].load(std::memory_order_relaxed);
+                    assigned[assigned_len++] = v;
+                }
+            }
+            peel();
+            for (int i = 0; i < remaining_len; i++)
+                if (component[remaining[i]] == -1) remaining[len++] = remaining[i];
+            remaining_len = len;
+            if (remaining_len == 0) {
+                phase = DONE;
+                return;
+            }
+            phase = COLOR;
+            for (int i = 0; i < remaining_len; i++) {
+                color[remaining[i]].store(remaining[i], std::memory_order_relaxed);
+                frontier[f_len++] = remaining[i];
+            }
+        };
+
+        // runs once per round by the last thread to finish it. a frontier smaller than a chunk would only keep
+        // one thread busy anyway, so it's expanded right here, without a barrier per round.
+        ArrayList<int> serial;
+        Barrier round_done(t, [&] {
+            const auto tmp = frontier;
+            frontier = next;
+            next = tmp;
+            f_len = next_len.load();
+            next_len = 0;
+            round++;
+            while (phase != DONE && f_len < CHUNK) {
+                if (f_len == 0) {
+                    advance();
+                    continue;
+                }
+                serial.clear();
+                for (int i = 0; i < f_len; i++) visit(frontier[i], serial);
+                for (int i = 0; i < serial.size(); i++) frontier[i] = serial[i];
+                f_len = serial.size();
+                round++;
+            }
+            cursor = 0;
+        });
+
+        run_threads(t, [&](int) {
+            ArrayList<int> local;
+            while (phase != DONE) {
+                local.clear();
+                for (int begin; (begin = cursor.fetch_add(CHUNK)) < f_len;) {
+                    const int end = begin + CHUNK < f_len ? begin + CHUNK : f_len;
+                    for (int i = begin; i < end; i++) visit(frontier[i], local);
+                }
+                const int at = next_len.fetch_add(local.size());
+                for (int i = 0; i < local.size(); i++) next[at + i] = local[i];
+                round_done.wait();
+            }
+        });
+
+        const auto components = new Components(n, component);
+        delete[] component;
+        delete[] in_degree;
+        delete[] out_degree;
+        delete[] assigned;
+        delete[] remaining;
+        delete[] mark;
+        delete[] color;
+        delete[] in_round;
+        delete[] frontier;
+        delete[] next;
+        delete incoming;
+        return components;
+    }
+
+    template<class G>
+    Graph *Algorithms::condensation_impl(const G *graph, const Components *scc) {
+        assert_graph(graph);
+        if (scc == nullptr || scc->n != graph->n) throw std::invalid_argument("components don't match graph");
+
+        int count = 0;
+        for (int u = 0; u < graph->n; u++)
+            for (auto neighbour = graph->neighbours(u); !neighbour.done(); neighbour.next())
+                if (scc->id[u] != scc->id[neighbour.vertex()]) count++;
+
+        const auto edges = new Graph::WeightedEdge[count];
+        int i = 0;
+        for (int u = 0; u < graph->n; u++)
+            for (auto neighbour = graph->neighbours(u); !neighbour.done(); neighbour.next())
+                if (const int cu = scc->id[u], cv = scc->id[neighbour.vertex()]; cu != cv)
+                    edges[i++] = Graph::WeightedEdge(cu, cv, neighbour.weight());
+
+        const auto dag = Graph::fromEdges(scc->count, graph->directed, edges, count);
+        delete[] edges;
+        return dag;
     }
 
-    Graph *Algorithms::djikstra(const Graph *graph, const int src) {
+    template<class G, class Q>
+    PathTree *Algorithms::djikstra_tree_impl(const G *graph, const int src) {
         assert_graph(graph);
         assert_graph_vtx(graph, src);
         assert_graph_non_negative(graph);
 
-        // shortest distances result table. nodes who have non-inf values here are finalised.
-        int s_dist[graph->n] = {};
-        for (int i = 0; i < graph->n; i++) s_dist[i] = Graph::VtxDist::INF;
-        s_dist[src] = 0;
+        // each node's shortest distance *so far* from src. nodes popped from the heap are finalised.
+        const auto s_dist = new Graph::VtxDist[graph->n];
+        for (int i = 0; i < graph->n; i++) s_dist[i] = Graph::VtxDist(src, i);
+        s_dist[src].relax(0);
         // shortest distances result tree.
-        const auto sp_result_graph = new Graph(graph, false);
-
-        // min heap containing each node's shortest distance *so far* from src.
-        Queue<Graph::VtxDist> d;
-        for (int i = 0; i < graph->n; i++)
-            if (i != src)
-                d.insert(Graph::VtxDist(src, i));
-        d.insert(Graph::VtxDist(src, src, 0));
-
-        // Find the shortest path for all vertices
-        for (int i = 0; i < graph->n; i++) {
-            // pop u with the minimal distance to src (first iteration pops src, sets result[src] to 0)
-            const Graph::VtxDist su = d.popMin();
-            const int u = su.vertex(), su_d = su.dist();
-            // node is fully relaxed, mark final & add to result (the shortest path tree)
-            s_dist[u] = su_d;
-            sp_result_graph->addEdge(src, u, su_d);
-
-            // relax u neighbours
-            auto n = graph->neighbour_list[u].head;
-            while (n) {
-                const int v = n->val.vertex, uv_w = n->val.weight;
-                Graph::VtxDist *sv = d.find(Graph::VtxDist(src, v));
-                // relax uv if:
-                //      u->v exists in g (we're iterating on u's neighbours so this is obv always true)
-                //      neighbour v isn't in sp yet (marked INF)
-                //      path src-->v->u is smaller than current distance src-->u
-                if (s_dist[v] == Graph::VtxDist::INF)
-                    sv->relax(su_d + uv_w);
-                n = n->next;
+        const auto tree = new PathTree(graph->n, src);
+
+        // indexed min heap of the reached, non-finalised nodes, keyed by distance.
+        Q d(graph->n);
+        d.insert(src, 0);
+
+        while (!d.isEmpty()) {
+            // pop u with the minimal distance to src (first iteration pops src). u is fully relaxed.
+            const int u = d.popMin(), su_d = s_dist[u].dist();
+            tree->dist[u] = su_d;
+
+            // relax u neighbours. weights are non-negative so finalised nodes can never be improved,
+            // and anything we improve is pushed (or decreased) in the heap.
+            for (auto n = graph->neighbours(u); !n.done(); n.next()) {
+                const int v = n.vertex();
+                if (s_dist[v].relax(static_cast<long long>(su_d) + n.weight())) {
+                    tree->parent[v] = u;
+                    d.push(v, s_dist[v].dist());
+                }
             }
         }
 
+        delete[] s_dist;
+        return tree;
+    }
+
+    template<class G>
+    PathTree *Algorithms::djikstra_tree_impl(const G *graph, const int src, const Heap heap) {
+        if (heap == Heap::Radix) return djikstra_tree_impl<G, RadixHeap>(graph, src);
+        return djikstra_tree_impl<G, IndexedMinHeap>(graph, src);
+    }
+
+    template<class G>
+    Graph *Algorithms::djikstra_impl(const G *graph, const int src, const Heap heap) {
+        const auto tree = djikstra_tree_impl(graph, src, heap);
+        // shortest distances result graph, src)-dist-(v. nodes that were never reached stay INF.
+        const auto edges = new Graph::WeightedEdge[graph->n];
+        for (int v = 0; v < graph->n; v++) edges[v] = Graph::WeightedEdge(src, v, tree->dist[v]);
+        const auto sp_result_graph = Graph::fromEdges(graph->n, graph->directed, edges, graph->n);
+        delete[] edges;
+        delete tree;
         return sp_result_graph;
     }
 
-    Graph *Algorithms::prim(const Graph *graph, const int src) {
+    template<class G>
+    PathTree *Algorithms::delta_stepping_impl(const G *graph, const int src, int delta, const int threads) {
         assert_graph(graph);
         assert_graph_vtx(graph, src);
+        assert_graph_non_negative(graph);
+        if (delta < 0) throw std::invalid_argument("delta must be non-negative");
+        const int n = graph->n, t = thread_count(threads);
+        constexpr int INF = Graph::VtxDist::INF;
+        constexpr int MAX_BUCKETS = 1024, CHUNK = 64; // CHUNK: frontier nodes a thread claims at once
 
-        const auto bfs = Algorithms::bfs(graph, src);
-        const int m = bfs->m();
-        if (bfs == nullptr || m < graph->n - 1) {
-            delete bfs;
-            throw std::invalid_argument("Graph is not connected from src");
+        int max_weight = 0;
+        long long degrees = 0;
+        for (int u = 0; u < n; u++)
+            for (auto it = graph->neighbours(u); !it.done(); it.next(), degrees++)
+                if (it.weight() > max_weight) max_weight = it.weight();
+        if (delta == 0) {
+            const long long average_degree = degrees / n > 0 ? degrees / n : 1;
+            delta = static_cast<int>(max_weight / average_degree > 0 ? max_weight / average_degree : 1);
         }
-        delete bfs;
-
-        const auto result = new Graph(graph, false);
-
-        bool in_mst[graph->n] = {};
-        Graph::Edge *min_edges[graph->n] = {};
-
-        in_mst[src] = true;
-
-        while (result->m() < graph->n - 1) {
-            for (int v = 0; v < graph->n; v++) {
-                if (in_mst[v]) {
-                    // we need IN->OUT edges.
-                    // (i) is in mst, find min neighbour that is OUT:
-                    Queue<Graph::Edge> q;
-                    q.insert(&graph->neighbour_list[v]);
-                    while (!q.isEmpty()) {
-                        // we want only edges that connect to OUT of mst,
-                        // so we discard edges (neighbours) that connect to vertexes we marked as IN the mst.
-                        const auto min = q.popMin();
-                        if (!in_mst[min.vertex]) {
-                            // collect min edge for vtx #i
-                            min_edges[v] = new Graph::Edge(min.vertex, min.weight);
-                            break;
+
+        // the cyclic bucket window needs max weight / delta + 2 buckets, delta is raised to keep that bounded
+        if (max_weight / delta + 2 > MAX_BUCKETS) delta = max_weight / (MAX_BUCKETS - 2) + 1;
+        const int bucket_count = max_weight / delta + 2;
+
+        // packed (distance, parent) per node
+        const auto state = new std::atomic<long long>[n];
+        for (int v = 0; v < n; v++) state[v].store(pack_dist(INF, -1), std::memory_order_relaxed);
+        state[src] = pack_dist(0, -1);
+        const auto bucket_of = [&](const int v) { return (state[v].load(std::memory_order_relaxed) >> 32) / delta; };
+
+        // every thread queues the nodes it improved in its own cyclic buckets:
+        // bins[thread * bucket_count + bucket % bucket_count]. tentative distances always lie within max weight of
+        // the current bucket, so they never wrap onto each other. a node is queued again on every improvement,
+        // entries left behind in higher buckets are skipped.
+        const auto bins = new ArrayList<int>[t * bucket_count];
+        const auto bin = [&](const int thread, const long long bucket) -> ArrayList<int> & {
+            return bins[thread * bucket_count + bucket % bucket_count];
+        };
+        const auto relax = [&](const int thread, const int u, const bool light) {
+            const long long du = state[u].load() >> 32;
+            for (auto it = graph->neighbours(u); !it.done(); it.next()) {
+                if ((it.weight() <= delta) != light) continue;
+                const int v = it.vertex();
+                const long long dv = du + it.weight(), desired = pack_dist(dv, u);
+                long long current = state[v].load(std::memory_order_relaxed);
+                while (dv < current >> 32 && !state[v].compare_exchange_weak(current, desired)) {
+                }
+                if (dv < current >> 32) bin(thread, dv / delta).add(v);
+            }
+        };
+
+        // the current bucket's nodes, gathered from every thread's bins once per light round
+        const auto frontier = new int[n];
+        const auto in_round = new std::atomic<long long>[n];
+        for (int v = 0; v < n; v++) in_round[v].store(-1, std::memory_order_relaxed);
+        std::atomic<int> frontier_len(0), cursor(0);
+        std::atomic<long long> next_bucket(LLONG_MAX);
+        long long bucket = 0, round = 0;
+        bin(0, 0).add(src);
+
+        // one team of threads for the whole run, phases split by barriers (completions run by the last thread in)
+        Barrier gathered(t, [&] { cursor = 0; });
+        Barrier light_done(t, [&] {
+            frontier_len = 0;
+            round++;
+        });
+        Barrier bucket_done(t, [&] {
+            bucket = next_bucket.load();
+            next_bucket = LLONG_MAX;
+        });
+
+        run_threads(t, [&](const int thread) {
+            // nodes this thread took out of the current bucket, their heavy edges are relaxed once it's settled
+            ArrayList<int> emptied;
+            while (bucket != LLONG_MAX) {
+                // empty the bucket through light edges, it may refill until its nodes are settled
+                while (true) {
+                    auto &mine = bin(thread, bucket);
+                    for (int i = 0; i < mine.size(); i++) {
+                        const int v = mine[i];
+                        if (bucket_of(v) != bucket || in_round[v].exchange(round) == round) continue;
+                        frontier[frontier_len.fetch_add(1)] = v;
+                        emptied.add(v);
+                    }
+                    mine.clear();
+                    gathered.wait();
+
+                    const int len = frontier_len.load();
+                    if (len == 0) break;
+                    for (int begin; (begin = cursor.fetch_add(CHUNK)) < len;) {
+                        const int end = begin + CHUNK < len ? begin + CHUNK : len;
+                        for (int i = begin; i < end; i++) relax(thread, frontier[i], true);
+                    }
+                    light_done.wait();
+                }
+
+                // heavy edges can't land back in this bucket, relax them once
+                for (int i = 0; i < emptied.size(); i++) relax(thread, emptied[i], false);
+                emptied.clear();
+
+                // this thread's lowest non-empty bucket, the lowest over all threads is next
+                for (int k = 1; k < bucket_count; k++)
+                    if (!bin(thread, bucket + k).isEmpty()) {
+                        long long current = next_bucket.load();
+                        while (bucket + k < current && !next_bucket.compare_exchange_weak(current, bucket + k)) {
                         }
+                        break;
                     }
+                bucket_done.wait();
+            }
+        });
+
+        const auto tree = unpack_dists(state, n, src);
+        delete[] state;
+        delete[] bins;
+        delete[] frontier;
+        delete[] in_round;
+        return tree;
+    }
+
+    template<class G>
+    PathTree *Algorithms::bellman_ford_impl(const G *graph, const int src) {
+        assert_graph(graph);
+        assert_graph_vtx(graph, src);
+        const int n = graph->n;
+
+        const auto tree = new PathTree(n, src);
+        // edges on the current best path to each node. a simple path has at most n - 1,
+        // so a node reaching n is fed by a negative cycle.
+        const auto hops = new int[n];
+        tree->dist[src] = 0;
+        hops[src] = 0;
+
+        // FIFO of the nodes whose edges need relaxing again, each queued at most once at a time
+        RingQueue<int> q(n);
+        Bitmap queued(n);
+        q.insert(src);
+        queued.set(src);
+
+        while (!q.isEmpty()) {
+            const int u = q.pop();
+            queued.unset(u);
+            const int du = tree->dist[u];
+            for (auto it = graph->neighbours(u); !it.done(); it.next()) {
+                // in long long: a sum past INF would wrap around to a bogus (negative) improvement.
+                // unreached nodes are at INF, so this also leaves unrepresentable distances out.
+                const int v = it.vertex();
+                const long long dv = static_cast<long long>(du) + it.weight();
+                if (dv >= tree->dist[v]) continue;
+                tree->dist[v] = dv;
+                tree->parent[v] = u;
+                hops[v] = hops[u] + 1;
+                if (hops[v] >= n) {
+                    delete[] hops;
+                    delete tree;
+                    throw std::domain_error("Graph has a negative cycle reachable from src");
+                }
+                if (!queued.get(v)) {
+                    q.insert(v);
+                    queued.set(v);
                 }
             }
-            // we have q with all minial edges from IN->OUT.
-            // pop min of that and we got true min edge that crosses.
-            int min_u = -1, min_w = INT_MAX;
-            for (int u = 0; u < graph->n; u++) {
-                if (min_edges[u])
-                    if (min_w > min_edges[u]->weight) {
-                        // track min edge
-                        min_u = u;
-                        min_w = min_edges[u]->weight;
-                    }
+        }
+
+        delete[] hops;
+        return tree;
+    }
+
+    template<class G>
+    PathTree *Algorithms::bellman_ford_parallel_impl(const G *graph, const int src, const int threads) {
+        assert_graph(graph);
+        assert_graph_vtx(graph, src);
+        const int n = graph->n, t = thread_count(threads);
+        constexpr int INF = Graph::VtxDist::INF;
+        constexpr int CHUNK = 64; // frontier nodes a thread claims at once
+
+        // packed (distance, parent) per node
+        const auto state = new std::atomic<long long>[n];
+        for (int v = 0; v < n; v++) state[v].store(pack_dist(INF, -1), std::memory_order_relaxed);
+        state[src] = pack_dist(0, -1);
+
+        // nodes improved in the previous round are relaxed in this one. a node is queued once per round
+        // however often it improves (the round it was last queued in).
+        auto frontier = new int[n], next = new int[n];
+        const auto in_round = new std::atomic<long long>[n];
+        for (int v = 0; v < n; v++) in_round[v].store(-1, std::memory_order_relaxed);
+        int f_len = 1;
+        frontier[0] = src;
+        long long round = 0;
+        bool cycle = false;
+        std::atomic<int> cursor(0), next_len(0);
+
+        const auto relax = [&](const int u, ArrayList<int> &improved) {
+            const long long du = state[u].load() >> 32;
+            for (auto it = graph->neighbours(u); !it.done(); it.next()) {
+                const int v = it.vertex();
+                const long long dv = du + it.weight(), desired = pack_dist(dv, u);
+                long long current = state[v].load(std::memory_order_relaxed);
+                while (dv < current >> 32 && !state[v].compare_exchange_weak(current, desired)) {
+                }
+                if (dv < current >> 32 && in_round[v].exchange(round) != round) improved.add(v);
+            }
+        };
+
+        // runs once per round by the last thread to finish it. without negative cycles everything settles within
+        // n - 1 rounds, so a round n means one. a frontier smaller than a chunk would only keep one thread busy
+        // anyway, so it's relaxed right here, without a barrier per round.
+        ArrayList<int> serial;
+        Barrier round_done(t, [&] {
+            const auto tmp = frontier;
+            frontier = next;
+            next = tmp;
+            f_len = next_len.load();
+            next_len = 0;
+            for (round++; f_len > 0 && round < n && f_len < CHUNK; round++) {
+                serial.clear();
+                for (int i = 0; i < f_len; i++) relax(frontier[i], serial);
+                for (int i = 0; i < serial.size(); i++) frontier[i] = serial[i];
+                f_len = serial.size();
             }
-            if (min_u != -1) {
-                // found new min edge to connect
-                const auto v = min_edges[min_u]->vertex;
-                // add new edge to mst
-                result->addEdge(min_u, v, min_w);
-                // mark added neighbour node as IN mst
-                in_mst[v] = true;
+            if (f_len > 0 && round >= n) {
+                cycle = true;
+                f_len = 0;
             }
-            // free & reset min edges list
-            for (int i = 0; i < graph->n; i++) {
-                if (min_edges[i]) {
-                    delete min_edges[i];
-                    min_edges[i] = nullptr;
+            cursor = 0;
+        });
+
+        run_threads(t, [&](int) {
+            ArrayList<int> local;
+            while (f_len > 0) {
+                local.clear();
+                for (int begin; (begin = cursor.fetch_add(CHUNK)) < f_len;) {
+                    const int end = begin + CHUNK < f_len ? begin + CHUNK : f_len;
+                    for (int i = begin; i < end; i++) relax(frontier[i], local);
                 }
+                const int at = next_len.fetch_add(local.size());
+                for (int i = 0; i < local.size(); i++) next[at + i] = local[i];
+                round_done.wait();
             }
+        });
+
+        delete[] frontier;
+        delete[] next;
+        delete[] in_round;
+        if (cycle) {
+            delete[] state;
+            throw std::domain_error("Graph has a negative cycle reachable from src");
         }
-        return result;
+        const auto tree = unpack_dists(state, n, src);
+        delete[] state;
+        return tree;
     }
 
-    Graph *Algorithms::kruskal(const Graph *graph) {
+    template<class G>
+    Graph *Algorithms::prim_impl(const G *graph, const int src) {
         assert_graph(graph);
+        assert_graph_vtx(graph, src);
 
-        const auto result = new Graph(graph, false);
-        // Sort all edges with min queue
-        Queue<Graph::VtxDist> edges;
-        // add all neighbours to queue
+        // lightest known edge connecting each OUT node to the mst: parent[v] -(key[v])- v
+        const auto key = new int[graph->n], parent = new int[graph->n];
         for (int v = 0; v < graph->n; v++) {
-            auto n = graph->neighbour_list[v].head;
-            while (n) {
-                const auto e = Graph::VtxDist(v, n->val.vertex, n->val.weight);
-                if (n->val.vertex > v) // skip duplicate edges, kruskal is undirected
-                    edges.insert(e);
-                n = n->next;
+            key[v] = Graph::VtxDist::INF;
+            parent[v] = -1;
+        }
+        Bitmap in_mst(graph->n);
+        // OUT nodes touched by the cut, keyed by their lightest crossing edge
+        IndexedMinHeap cut(graph->n);
+
+        int in = 0;
+        cut.insert(src, 0);
+        while (!cut.isEmpty()) {
+            // lightest IN->OUT edge, mark its OUT node as IN
+            const int u = cut.popMin();
+            in_mst.set(u);
+            in++;
+
+            // u's edges to OUT nodes now cross the cut
+            for (auto n = graph->neighbours(u); !n.done(); n.next()) {
+                const int v = n.vertex(), w = n.weight();
+                if (!in_mst.get(v) && w < key[v]) {
+                    key[v] = w;
+                    parent[v] = u;
+                    cut.push(v, w);
+                }
             }
         }
 
+        if (in < graph->n) {
+            delete[] key;
+            delete[] parent;
+            throw std::invalid_argument("Graph is not connected from src");
+        }
+
+        // IN nodes keep the edge they joined by
+        const auto edges = new Graph::WeightedEdge[graph->n];
+        int count = 0;
+        for (int v = 0; v < graph->n; v++)
+            if (parent[v] != -1) edges[count++] = Graph::WeightedEdge(parent[v], v, key[v]);
+        const auto result = Graph::fromEdges(graph->n, graph->directed, edges, count);
+
+        delete[] edges;
+        delete[] key;
+        delete[] parent;
+        return result;
+    }
+
+    template<class G>
+    Graph::WeightedEdge *Algorithms::undirected_edges(const G *graph, int &count) {
+        count = 0;
+        for (int u = 0; u < graph->n; u++)
+            for (auto n = graph->neighbours(u); !n.done(); n.next())
+                if (n.vertex() > u) count++;
+
+        const auto edges = new Graph::WeightedEdge[count];
+        int i = 0;
+        for (int u = 0; u < graph->n; u++)
+            for (auto n = graph->neighbours(u); !n.done(); n.next())
+                if (n.vertex() > u) // skip duplicate edges, treated as undirected
+                    edges[i++] = Graph::WeightedEdge(u, n.vertex(), n.weight());
+        return edges;
+    }
+
+    template<class G>
+    Graph *Algorithms::kruskal_impl(const G *graph) {
+        assert_graph(graph);
+
+        // flat array of all edges, sorted by weight
+        int count;
+        const auto edges = undirected_edges(graph, count);
+        std::sort(edges, edges + count);
+        // picked edges (at most n - 1)
+        const auto tree = new Graph::WeightedEdge[graph->n];
+
         // with kruskal we use a union set for vertex connectivity
         UnionSet vertexes(graph->n);
         int m = 0;
-        while (!edges.isEmpty() && m < graph->n) {
+        // a spanning tree is done after n-1 unions
+        for (int i = 0; i < count && m < graph->n - 1; i++) {
             // try to add most minimal edge
-            const auto e = edges.popMin();
-            const int u = e.src, v = e.vertex(), w = e.weight;
+            const int u = edges[i].u, v = edges[i].v, w = edges[i].weight;
 
             // check for cycle (u v are united)
             if (vertexes.find(u) != vertexes.find(v)) {
                 // mark uv as added, unite nodes on edge uv
                 vertexes.unite(u, v);
-                // add edge count
-                result->addEdge(u, v, w);
-                m++;
+                // keep the edge, count it
+                tree[m++] = Graph::WeightedEdge(u, v, w);
+            }
+        }
+
+        const auto result = Graph::fromEdges(graph->n, graph->directed, tree, m);
+        delete[] tree;
+        delete[] edges;
+        return result;
+    }
+
+    void Algorithms::filter_kruskal(Graph::WeightedEdge *begin, Graph::WeightedEdge *end,
+                                    UnionSet &vertexes, const int n, Graph::WeightedEdge *tree, int &m) {
+        constexpr int SORT_THRESHOLD = 64;
+        if (m >= n - 1 || begin == end) return;
+
+        const auto kruskal_step = [&](const Graph::WeightedEdge &e) {
+            if (m < n - 1 && vertexes.find(e.u) != vertexes.find(e.v)) {
+                vertexes.unite(e.u, e.v);
+                tree[m++] = e;
+            }
+        };
+
+        if (end - begin <= SORT_THRESHOLD) {
+            std::sort(begin, end);
+            for (auto e = begin; e != end; e++) kruskal_step(*e);
+            return;
+        }
+
+        // median of 3 pivot weight, three way partition: [begin, light) < pivot <= [light, heavy) < pivot < [heavy, end)
+        const int a = begin->weight, b = begin[(end - begin) / 2].weight, c = (end - 1)->weight;
+        const int pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+        const auto light = std::partition(begin, end, [pivot](const Graph::WeightedEdge &e) { return e.weight < pivot; });
+        const auto heavy = std::partition(light, end, [pivot](const Graph::WeightedEdge &e) { return e.weight == pivot; });
+
+        filter_kruskal(begin, light, vertexes, n, tree, m);
+        // all pivot weight edges tie, no sorting needed
+        for (auto e = light; e != heavy; e++) kruskal_step(*e);
+        if (m >= n - 1) return;
+
+        // filter: heavy edges whose ends are already joined can never be in the mst
+        const auto kept = std::partition(heavy, end, [&vertexes](const Graph::WeightedEdge &e) {
+            return vertexes.find(e.u) != vertexes.find(e.v);
+        });
+        filter_kruskal(heavy, kept, vertexes, n, tree, m);
+    }
+
+    template<class G>
+    Graph *Algorithms::filter_kruskal_impl(const G *graph) {
+        assert_graph(graph);
+
+        int count, m = 0;
+        const auto edges = undirected_edges(graph, count);
+        // picked edges (at most n - 1)
+        const auto tree = new Graph::WeightedEdge[graph->n];
+        UnionSet vertexes(graph->n);
+        filter_kruskal(edges, edges + count, vertexes, graph->n, tree, m);
+        const auto result = Graph::fromEdges(graph->n, graph->directed, tree, m);
+        delete[] tree;
+        delete[] edges;
+        return result;
+    }
+
+    template<class G>
+    Graph *Algorithms::boruvka_impl(const G *graph, const int threads) {
+        assert_graph(graph);
+        const int n = graph->n, t = thread_count(threads);
+        constexpr long long NONE = LLONG_MAX;
+
+        int count, m = 0;
+        const auto edges = undirected_edges(graph, count);
+        // picked edges, the result graph is built from them at the end
+        const auto tree = new Graph::WeightedEdge[n];
+        // an edge's rank: weight, then index. a strict total order, so components' picks can't form a cycle.
+        const auto rank = [edges](const int i) {
+            return static_cast<long long>(edges[i].weight) * (1LL << 32) + i;
+        };
+
+        ConcurrentUnionSet vertexes(n);
+        const auto component = new int[n];
+        const auto lightest = new std::atomic<long long>[n];
+        const auto picked = new bool[n];
+
+        for (bool merged = true; merged && m < n - 1;) {
+            run_threads(t, [&](const int thread) {
+                for (int v = thread; v < n; v += t) {
+                    component[v] = vertexes.find(v);
+                    lightest[v].store(NONE, std::memory_order_relaxed);
+                }
+            });
+
+            // each thread scans its slice of the edges for every component's lightest outgoing edge
+            run_threads(t, [&](const int thread) {
+                const int begin = static_cast<int>(static_cast<long long>(count) * thread / t),
+                        end = static_cast<int>(static_cast<long long>(count) * (thread + 1) / t);
+                for (int i = begin; i < end; i++) {
+                    const int cu = component[edges[i].u], cv = component[edges[i].v];
+                    if (cu == cv) continue;
+                    const long long r = rank(i);
+                    for (const int c: {cu, cv}) {
+                        long long current = lightest[c].load(std::memory_order_relaxed);
+                        while (r < current && !lightest[c].compare_exchange_weak(current, r)) {
+                        }
+                    }
+                }
+            });
+
+            // merge along every component's pick in parallel.
+            // two components may pick the same edge, only one unite wins it.
+            run_threads(t, [&](const int thread) {
+                for (int c = thread; c < n; c += t) {
+                    picked[c] = false;
+                    if (lightest[c] == NONE) continue;
+                    const auto &e = edges[lightest[c] & 0xFFFFFFFFLL];
+                    picked[c] = vertexes.unite(e.u, e.v);
+                }
+            });
+
+            merged = false;
+            for (int c = 0; c < n; c++) {
+                if (!picked[c]) continue;
+                const auto &e = edges[lightest[c] & 0xFFFFFFFFLL];
+                tree[m++] = e;
+                merged = true;
             }
         }
+
+        const auto result = Graph::fromEdges(n, graph->directed, tree, m);
+        delete[] tree;
+        delete[] picked;
+        delete[] component;
+        delete[] lightest;
+        delete[] edges;
         return result;
     }
 
+    Graph *Algorithms::bfs(const Graph *graph, const int src) { return bfs_impl(graph, src); }
+
+    Graph *Algorithms::bfs(const CSRGraph &graph, const int src) { return bfs_impl(&graph, src); }
+
+    PathTree *Algorithms::bfsTree(const Graph *graph, const int src) { return bfs_tree_impl(graph, src); }
+
+    PathTree *Algorithms::bfsTree(const CSRGraph &graph, const int src) { return bfs_tree_impl(&graph, src); }
+
+    PathTree *Algorithms::bfsHybrid(const Graph *graph, const int src, const int alpha, const int beta) {
+        assert_graph(graph);
+        assert_graph_vtx(graph, src);
+        if (!graph->directed) return bfs_hybrid_impl(graph, graph, src, alpha, beta);
+
+        // bottom-up steps walk incoming edges
+        const auto incoming = CSRGraph::transpose(graph);
+        const auto tree = bfs_hybrid_impl(graph, incoming, src, alpha, beta);
+        delete incoming;
+        return tree;
+    }
+
+    PathTree *Algorithms::bfsHybrid(const CSRGraph &graph, const int src, const int alpha, const int beta) {
+        assert_graph(&graph);
+        assert_graph_vtx(&graph, src);
+        if (!graph.directed) return bfs_hybrid_impl(&graph, &graph, src, alpha, beta);
+
+        const auto incoming = CSRGraph::transpose(&graph);
+        const auto tree = bfs_hybrid_impl(&graph, incoming, src, alpha, beta);
+        delete incoming;
+        return tree;
+    }
+
+    PathTree *Algorithms::bfsParallel(const Graph *graph, const int src, const int threads) {
+        return bfs_parallel_impl(graph, src, threads);
+    }
+
+    PathTree *Algorithms::bfsParallel(const CSRGraph &graph, const int src, const int threads) {
+        return bfs_parallel_impl(&graph, src, threads);
+    }
+
+    Graph **Algorithms::dfs(const Graph *graph, const int src) { return dfs_impl(graph, src); }
+
+    Graph **Algorithms::dfs(const CSRGraph &graph, const int src) { return dfs_impl(&graph, src); }
+
+    DFSForest *Algorithms::dfsForest(const Graph *graph, const int src) { return dfs_forest_impl(graph, src); }
+
+    DFSForest *Algorithms::dfsForest(const CSRGraph &graph, const int src) { return dfs_forest_impl(&graph, src); }
+
+    Components *Algorithms::connectedComponents(const Graph *graph) { return components_impl(graph); }
+
+    Components *Algorithms::connectedComponents(const CSRGraph &graph) { return components_impl(&graph); }
+
+    Components *Algorithms::connectedComponentsParallel(const Graph *graph, const int threads) {
+        return components_parallel_impl(graph, threads);
+    }
+
+    Components *Algorithms::connectedComponentsParallel(const CSRGraph &graph, const int threads) {
+        return components_parallel_impl(&graph, threads);
+    }
+
+    Components *Algorithms::stronglyConnectedComponents(const Graph *graph) { return scc_impl(graph); }
+
+    Components *Algorithms::stronglyConnectedComponents(const CSRGraph &graph) { return scc_impl(&graph); }
+
+    Components *Algorithms::stronglyConnectedComponentsParallel(const Graph *graph, const int threads) {
+        return scc_parallel_impl(graph, threads);
+    }
+
+    Components *Algorithms::stronglyConnectedComponentsParallel(const CSRGraph &graph, const int threads) {
+        return scc_parallel_impl(&graph, threads);
+    }
+
+    Graph *Algorithms::condensation(const Graph *graph, const Components *scc) {
+        return condensation_impl(graph, scc);
+    }
+
+    Graph *Algorithms::condensation(const CSRGraph &graph, const Components *scc) {
+        return condensation_impl(&graph, scc);
+    }
+
+    Graph *Algorithms::djikstra(const Graph *graph, const int src, const Heap heap) {
+        return djikstra_impl(graph, src, heap);
+    }
+
+    Graph *Algorithms::djikstra(const CSRGraph &graph, const int src, const Heap heap) {
+        return djikstra_impl(&graph, src, heap);
+    }
+
+    PathTree *Algorithms::djikstraTree(const Graph *graph, const int src, const Heap heap) {
+        return djikstra_tree_impl(graph, src, heap);
+    }
+
+    PathTree *Algorithms::djikstraTree(const CSRGraph &graph, const int src, const Heap heap) {
+        return djikstra_tree_impl(&graph, src, heap);
+    }
+
+    PathTree *Algorithms::deltaStepping(const Graph *graph, const int src, const int delta, const int threads) {
+        return delta_stepping_impl(graph, src, delta, threads);
+    }
+
+    PathTree *Algorithms::deltaStepping(const CSRGraph &graph, const int src, const int delta, const int threads) {
+        return delta_stepping_impl(&graph, src, delta, threads);
+    }
+
+    PathTree *Algorithms::bellmanFord(const Graph *graph, const int src) { return bellman_ford_impl(graph, src); }
+
+    PathTree *Algorithms::bellmanFord(const CSRGraph &graph, const int src) { return bellman_ford_impl(&graph, src); }
+
+    PathTree *Algorithms::bellmanFordParallel(const Graph *graph, const int src, const int threads) {
+        return bellman_ford_parallel_impl(graph, src, threads);
+    }
+
+    PathTree *Algorithms::bellmanFordParallel(const CSRGraph &graph, const int src, const int threads) {
+        return bellman_ford_parallel_impl(&graph, src, threads);
+    }
+
+    Path *Algorithms::bidirectionalDjikstra(const Graph *graph, const int src, const int dst) {
+        return BidirectionalDjikstra(graph).query(src, dst);
+    }
+
+    Path *Algorithms::bidirectionalDjikstra(const CSRGraph &graph, const int src, const int dst) {
+        return BidirectionalDjikstra(graph).query(src, dst);
+    }
+
+    Graph *Algorithms::prim(const Graph *graph, const int src) { return prim_impl(graph, src); }
+
+    Graph *Algorithms::prim(const CSRGraph &graph, const int src) { return prim_impl(&graph, src); }
+
+    Graph *Algorithms::kruskal(const Graph *graph) { return kruskal_impl(graph); }
+
+    Graph *Algorithms::kruskal(const CSRGraph &graph) { return kruskal_impl(&graph); }
+
+    Graph *Algorithms::filterKruskal(const Graph *graph) { return filter_kruskal_impl(graph); }
+
+    Graph *Algorithms::filterKruskal(const CSRGraph &graph) { return filter_kruskal_impl(&graph); }
+
+    Graph *Algorithms::boruvka(const Graph *graph, const int threads) { return boruvka_impl(graph, threads); }
+
+    Graph *Algorithms::boruvka(const CSRGraph &graph, const int threads) { return boruvka_impl(&graph, threads); }
+
+    /* Bidirectional Djikstra */
+
+    BidirectionalDjikstra::BidirectionalDjikstra(const Graph *graph) : n(graph ? graph->n : 0) {
+        assert_graph(graph);
+        assert_graph_non_negative(graph);
+        outgoing = new CSRGraph(graph);
+        owns_outgoing = true;
+        incoming = graph->directed ? CSRGraph::transpose(outgoing) : outgoing;
+        owns_incoming = graph->directed;
+        allocate();
+    }
+
+    BidirectionalDjikstra::BidirectionalDjikstra(const CSRGraph &graph, const CSRGraph *incoming)
+        : outgoing(&graph), incoming(incoming), n(graph.n) {
+        assert_graph(&graph);
+        assert_graph_non_negative(&graph);
+        if (incoming && incoming->n != n) throw std::invalid_argument("incoming graph doesn't match graph");
+        if (!incoming) {
+            this->incoming = graph.directed ? CSRGraph::transpose(&graph) : &graph;
+            owns_incoming = graph.directed;
+        }
+        allocate();
+    }
+
+    void BidirectionalDjikstra::allocate() {
+        for (int side = 0; side < 2; side++) {
+            dist[side] = new int[n];
+            parent[side] = new int[n];
+            for (int v = 0; v < n; v++) dist[side][v] = Graph::VtxDist::INF, parent[side][v] = -1;
+            heap[side] = new IndexedMinHeap(n);
+            settled[side] = new Bitmap(n);
+            touched[side] = new ArrayList<int>();
+        }
+    }
+
+    BidirectionalDjikstra::~BidirectionalDjikstra() {
+        for (int side = 0; side < 2; side++) {
+            delete[] dist[side];
+            delete[] parent[side];
+            delete heap[side];
+            delete settled[side];
+            delete touched[side];
+        }
+        if (owns_incoming) delete incoming;
+        if (owns_outgoing) delete outgoing;
+    }
+
+    Path *BidirectionalDjikstra::query(const int src, const int dst) const {
+        assert_graph_vtx(outgoing, src);
+        assert_graph_vtx(outgoing, dst);
+        constexpr int INF = Graph::VtxDist::INF;
+        const auto path = new Path(src, dst);
+
+        // side 0 searches forward from src, side 1 backward from dst
+        const CSRGraph *graph[] = {outgoing, incoming};
+        const int root[] = {src, dst};
+        for (int side = 0; side < 2; side++) {
+            dist[side][root[side]] = 0;
+            touched[side]->add(root[side]);
+            heap[side]->insert(root[side], 0);
+        }
+        // best src-->meet-->dst seen so far
+        int best = src == dst ? 0 : INF, meet = src == dst ? src : -1;
+
+        while (!heap[0]->isEmpty() && !heap[1]->isEmpty()) {
+            const int top_f = heap[0]->keyOf(heap[0]->peekMin()), top_b = heap[1]->keyOf(heap[1]->peekMin());
+            // nothing left in either frontier can make a shorter path
+            if (best != INF && static_cast<long long>(top_f) + top_b >= best) break;
+
+            const int side = top_f <= top_b ? 0 : 1, other = 1 - side;
+            const int u = heap[side]->popMin(), du = dist[side][u];
+            settled[side]->set(u);
+
+            for (auto neighbour = graph[side]->neighbours(u); !neighbour.done(); neighbour.next()) {
+                const int v = neighbour.vertex();
+                if (settled[side]->get(v)) continue;
+                // summed wide, a path at or past INF stays unreached
+                if (const long long dv = static_cast<long long>(du) + neighbour.weight(); dv < dist[side][v]) {
+                    if (dist[side][v] == INF) touched[side]->add(v);
+                    dist[side][v] = static_cast<int>(dv);
+                    parent[side][v] = u;
+                    heap[side]->push(v, dv);
+                }
+                if (dist[other][v] != INF && static_cast<long long>(dist[side][v]) + dist[other][v] < best) {
+                    best = dist[side][v] + dist[other][v];
+                    meet = v;
+                }
+            }
+        }
+
+        if (meet != -1) {
+            path->dist = best;
+            // src-->meet along forward parents, then meet-->dst along backward parents
+            for (int v = meet; v != -1; v = parent[0][v]) path->length++;
+            for (int v = parent[1][meet]; v != -1; v = parent[1][v]) path->length++;
+            path->vertices = new int[path->length];
+            int i = 0;
+            for (int v = meet; v != -1; v = parent[0][v]) path->vertices[i++] = v;
+            std::reverse(path->vertices, path->vertices + i);
+            for (int v = parent[1][meet]; v != -1; v = parent[1][v]) path->vertices[i++] = v;
+        }
+
+        // reset only what this query touched
+        for (int side = 0; side < 2; side++) {
+            for (int i = 0; i < touched[side]->size(); i++) {
+                const int v = (*touched[side])[i];
+                dist[side][v] = INF;
+                parent[side][v] = -1;
+                settled[side]->unset(v);
+            }
+            touched[side]->clear();
+            heap[side]->clear();
+        }
+        return path;
+    }
+
+    /* Landmarks */
+
+    Landmarks::Landmarks(const Graph *graph, const int k)
+        : n(graph ? graph->n : 0), k(k), directed(graph && graph->directed) {
+        preprocess(graph);
+    }
+
+    Landmarks::Landmarks(const CSRGraph &graph, const int k) : n(graph.n), k(k), directed(graph.directed) {
+        preprocess(&graph);
+    }
+
+    template<class G>
+    void Landmarks::preprocess(const G *graph) {
+        assert_graph(graph);
+        assert_graph_non_negative(graph);
+        if (k < 1 || k > n) throw std::invalid_argument("landmark count must be in 1..n");
+        constexpr int INF = Graph::VtxDist::INF;
+
+        landmarks = new int[k];
+        from = new int[static_cast<long long>(k) * n];
+        to = from;
+        const auto incoming = directed ? CSRGraph::transpose(graph) : nullptr;
+        if (directed) to = new int[static_cast<long long>(k) * n];
+
+        // farthest point selection: start from the node farthest from 0,
+        // then keep adding the node farthest from all landmarks so far (unreachable counts as farthest)
+        const auto nearest = new int[n];
+        const auto start = Algorithms::djikstra_tree_impl(graph, 0);
+        int next = 0;
+        for (int v = 0; v < n; v++) {
+            nearest[v] = INF;
+            if (start->reached(v) && start->dist[v] > start->dist[next]) next = v;
+        }
+        delete start;
+
+        for (int i = 0; i < k; i++) {
+            landmarks[i] = next;
+            const auto tree = Algorithms::djikstra_tree_impl(graph, next);
+            for (int v = 0; v < n; v++) from[static_cast<long long>(i) * n + v] = tree->dist[v];
+            delete tree;
+            if (incoming) {
+                const auto back = Algorithms::djikstraTree(*incoming, next);
+                for (int v = 0; v < n; v++) to[static_cast<long long>(i) * n + v] = back->dist[v];
+                delete back;
+            }
+
+            next = -1;
+            for (int v = 0; v < n; v++) {
+                const int d = from[static_cast<long long>(i) * n + v];
+                if (d < nearest[v]) nearest[v] = d;
+                if (nearest[v] != 0 && (next == -1 || nearest[v] > nearest[next])) next = v;
+            }
+            if (next == -1) next = landmarks[i]; // every node is a landmark already
+        }
+
+        delete[] nearest;
+        delete incoming;
+    }
+
+    int Landmarks::lowerBound(const int v, const int t) const {
+        constexpr int INF = Graph::VtxDist::INF;
+        int bound = 0;
+        for (int i = 0; i < k; i++) {
+            const int *l_from = from + static_cast<long long>(i) * n, *l_to = to + static_cast<long long>(i) * n;
+            // d(v,t) >= d(L,t) - d(L,v)
+            if (l_from[v] != INF && l_from[t] != INF && l_from[t] - l_from[v] > bound) bound = l_from[t] - l_from[v];
+            // d(v,t) >= d(v,L) - d(t,L)
+            if (l_to[v] != INF && l_to[t] != INF && l_to[v] - l_to[t] > bound) bound = l_to[v] - l_to[t];
+        }
+        return bound;
+    }
+
+    int Landmarks::upperBound(const int v, const int t) const {
+        constexpr int INF = Graph::VtxDist::INF;
+        if (v == t) return 0;
+        int bound = INF;
+        for (int i = 0; i < k; i++) {
+            const int to_l = to[static_cast<long long>(i) * n + v], from_l = from[static_cast<long long>(i) * n + t];
+            // summed wide, so a bound past INT_MAX is just no bound
+            if (to_l != INF && from_l != INF && static_cast<long long>(to_l) + from_l < bound) bound = to_l + from_l;
+        }
+        return bound;
+    }
+
+    /* Contraction Hierarchies */
+
+    ContractionHierarchy::ContractionHierarchy(const Graph *graph)
+        : n(graph ? graph->n : 0), directed(graph && graph->directed) {
+        preprocess(graph);
+    }
+
+    ContractionHierarchy::ContractionHierarchy(const CSRGraph &graph) : n(graph.n), directed(graph.directed) {
+        preprocess(&graph);
+    }
+
+    unsigned long long ContractionHierarchy::edgeKey(int u, int w) const {
+        if (!directed && u > w) {
+            const int tmp = u;
+            u = w;
+            w = tmp;
+        }
+        return static_cast<unsigned long long>(u) << 32 | static_cast<unsigned>(w);
+    }
+
+    template<class G>
+    void ContractionHierarchy::preprocess(const G *graph) {
+        assert_graph(graph);
+        assert_graph_non_negative(graph);
+        constexpr int INF = Graph::VtxDist::INF;
+
+        rank = new int[n];
+        middle = new HashIndex();
+
+        // working graph of the uncontracted nodes: edge lists (incoming too, if directed), one edge per u->w
+        // at its lightest weight. the weights are also kept in a map, so finding an edge is O(1)
+        const auto out = new ArrayList<Graph::Edge>[n];
+        const auto in = directed ? new ArrayList<Graph::Edge>[n] : out;
+        HashIndex weights(n);
+        const auto set_weight = [](ArrayList<Graph::Edge> &list, const int v, const int weight) {
+            for (int i = 0; i < list.size(); i++)
+                if (list[i].vertex == v) list[i].weight = weight;
+        };
+        // adds u->w, or lowers its weight. false if an edge at least as light is already there
+        const auto add_edge = [&](const int u, const int w, const int weight) {
+            if (u == w) return false;
+            const auto key = edgeKey(u, w);
+            if (const int *current = weights.find(key)) {
+                if (*current <= weight) return false;
+                set_weight(out[u], w, weight);
+                set_weight(in[w], u, weight);
+            } else {
+                out[u].add(Graph::Edge(w, weight));
+                in[w].add(Graph::Edge(u, weight));
+            }
+            weights.put(key, weight);
+            return true;
+        };
+        for (int u = 0; u < n; u++)
+            for (auto it = graph->neighbours(u); !it.done(); it.next()) add_edge(u, it.vertex(), it.weight());
+
+        // witness search scratch, reset through the touched list
+        const auto dist = new int[n];
+        for (int v = 0; v < n; v++) dist[v] = INF;
+        ArrayList<int> touched;
+        IndexedMinHeap witness_heap(n);
+
+        // v's out neighbours, the nodes witness searches look for
+        Bitmap target(n);
+
+        // shortest distances from u avoiding v, settled until the targets are, past limit or settle_limit nodes.
+        // the rest stay tentative, which is only ever too long: an overlooked witness costs a redundant shortcut.
+        const auto witness_search = [&](const int u, const int v, const long long limit, int targets, const int settle_limit) {
+            dist[u] = 0;
+            touched.add(u);
+            witness_heap.insert(u, 0);
+            for (int settled = 0; !witness_heap.isEmpty() && settled < settle_limit; settled++) {
+                const int x = witness_heap.popMin();
+                if (dist[x] > limit || (x != u && target.get(x) && --targets == 0)) break;
+                for (int i = 0; i < out[x].size(); i++) {
+                    const int y = out[x][i].vertex;
+                    if (y == v) continue;
+                    if (const long long d = static_cast<long long>(dist[x]) + out[x][i].weight; d < dist[y]) {
+                        if (dist[y] == INF) touched.add(y);
+                        dist[y] = static_cast<int>(d);
+                        witness_heap.push(y, dist[y]);
+                    }
+                }
+            }
+            witness_heap.clear();
+        };
+        const auto reset_witness = [&] {
+            for (int i = 0; i < touched.size(); i++) dist[touched[i]] = INF;
+            touched.clear();
+        };
+
+        // shortcuts contracting v needs, added unless simulating. returns how many.
+        const auto contract = [&](const int v, const bool simulate) {
+            int added = 0, max_out = 0;
+            for (int i = 0; i < out[v].size(); i++) {
+                if (out[v][i].weight > max_out) max_out = out[v][i].weight;
+                target.set(out[v][i].vertex);
+            }
+            for (int i = 0; i < in[v].size(); i++) {
+                const int u = in[v][i].vertex, to_v = in[v][i].weight;
+                const int targets = out[v].size() - (target.get(u) ? 1 : 0);
+                if (targets == 0) continue;
+                witness_search(u, v, static_cast<long long>(to_v) + max_out, targets, simulate ? SIMULATE_SETTLE_LIMIT : WITNESS_SETTLE_LIMIT);
+                for (int j = 0; j < out[v].size(); j++) {
+                    const int w = out[v][j].vertex;
+                    // undirected pairs are seen twice, handle each once
+                    if (w == u || (!directed && w < u)) continue;
+                    // the direct u->w edge (if any) was relaxed first thing, so it's a witness too.
+                    // a via at or past INF is no path at all, so never a shortcut
+                    const long long via = static_cast<long long>(to_v) + out[v][j].weight;
+                    if (dist[w] <= via) continue;
+
+                    added++;
+                    if (simulate || !add_edge(u, w, static_cast<int>(via))) continue;
+                    middle->put(edgeKey(u, w), v);
+                    shortcuts++;
+                }
+                reset_witness();
+            }
+            for (int i = 0; i < out[v].size(); i++) target.unset(out[v][i].vertex);
+            return added;
+        };
+
+        const auto contracted_neighbours = new int[n]();
+        const auto importance = [&](const int v) {
+            const int removed = out[v].size() + (directed ? in[v].size() : 0);
+            return 2 * (contract(v, true) - removed) + contracted_neighbours[v];
+        };
+
+        // drops the edge to v from list, swapping the last edge into its place
+        const auto unlink = [](ArrayList<Graph::Edge> &list, const int v) {
+            for (int i = 0; i < list.size(); i++)
+                if (list[i].vertex == v) {
+                    list[i] = list[list.size() - 1];
+                    list.pop();
+                    return;
+                }
+        };
+
+        // every augmented edge, collected from its lower ranked end when that's contracted
+        ArrayList<Graph::WeightedEdge> edges(2 * n);
+        // nodes with a contracted neighbour since their importance was computed
+        Bitmap stale(n);
+        IndexedMinHeap order(n);
+        for (int v = 0; v < n; v++) order.insert(v, importance(v));
+        for (int next_rank = 0; !order.isEmpty();) {
+            const int v = order.popMin();
+            // lazy update: v's importance may have grown since it was queued
+            if (stale.get(v)) {
+                stale.unset(v);
+                if (const int current = importance(v); !order.isEmpty() && current > order.keyOf(order.peekMin())) {
+                    order.insert(v, current);
+                    continue;
+                }
+            }
+            contract(v, false);
+            rank[v] = next_rank++;
+
+            // v leaves the working graph, its remaining edges all lead to higher ranked nodes
+            for (int i = 0; i < out[v].size(); i++) {
+                const int w = out[v][i].vertex;
+                edges.add(Graph::WeightedEdge(v, w, out[v][i].weight));
+                unlink(in[w], v);
+                contracted_neighbours[w]++;
+                stale.set(w);
+            }
+            if (directed)
+                for (int i = 0; i < in[v].size(); i++) {
+                    const int u = in[v][i].vertex;
+                    edges.add(Graph::WeightedEdge(u, v, in[v][i].weight));
+                    unlink(out[u], v);
+                    contracted_neighbours[u]++;
+                    stale.set(u);
+                }
+            out[v].clear();
+            in[v].clear();
+        }
+
+        delete[] dist;
+        delete[] contracted_neighbours;
+        delete[] out;
+        if (directed) delete[] in;
+
+        augmented = Graph::fromEdges(n, directed, &edges[0], edges.size());
+
+        // split the augmented edges by rank into the two upward search graphs
+        const auto up_offsets = new int[n + 1](), in_offsets = new int[n + 1]();
+        for (int i = 0; i < edges.size(); i++) {
+            const auto &e = edges[i];
+            if (rank[e.v] > rank[e.u]) up_offsets[e.u + 1]++;
+            else in_offsets[e.v + 1]++; // u->v, reached from v going up to u (only on directed graphs)
+        }
+        for (int v = 0; v < n; v++) {
+            up_offsets[v + 1] += up_offsets[v];
+            in_offsets[v + 1] += in_offsets[v];
+        }
+        const auto up_targets = new int[up_offsets[n]], up_weights = new int[up_offsets[n]];
+        const auto in_targets = new int[in_offsets[n]], in_weights = new int[in_offsets[n]];
+        const auto up_fill = new int[n], in_fill = new int[n];
+        for (int v = 0; v < n; v++) up_fill[v] = up_offsets[v], in_fill[v] = in_offsets[v];
+        for (int i = 0; i < edges.size(); i++) {
+            const auto &e = edges[i];
+            if (rank[e.v] > rank[e.u]) {
+                up_targets[up_fill[e.u]] = e.v;
+                up_weights[up_fill[e.u]++] = e.weight;
+            } else {
+                in_targets[in_fill[e.v]] = e.u;
+                in_weights[in_fill[e.v]++] = e.weight;
+            }
+        }
+        delete[] up_fill;
+        delete[] in_fill;
+
+        upward = new CSRGraph(n, directed, up_offsets, up_targets, up_weights);
+        if (directed) upward_in = new CSRGraph(n, directed, in_offsets, in_targets, in_weights);
+        else {
+            upward_in = upward;
+            delete[] in_offsets;
+            delete[] in_targets;
+            delete[] in_weights;
+        }
+
+        for (int side = 0; side < 2; side++) {
+            query_dist[side] = new int[n];
+            query_parent[side] = new int[n];
+            for (int v = 0; v < n; v++) query_dist[side][v] = INF, query_parent[side][v] = -1;
+            query_heap[side] = new IndexedMinHeap(n);
+            query_touched[side] = new ArrayList<int>();
+        }
+        unpack_stack = new ArrayList<int>();
+        unpacked = new ArrayList<int>();
+    }
+
+    Path *ContractionHierarchy::query(const int src, const int dst) const {
+        if (src < 0 || src >= n) throw std::invalid_argument("node " + std::to_string(src) + " doesn't exist");
+        if (dst < 0 || dst >= n) throw std::invalid_argument("node " + std::to_string(dst) + " doesn't exist");
+        constexpr int INF = Graph::VtxDist::INF;
+        const auto path = new Path(src, dst);
+
+        // side 0 climbs from src along upward edges, side 1 from dst along upward incoming edges
+        const auto dist = query_dist, parent = query_parent;
+        const auto heap = query_heap;
+        const CSRGraph *graph[] = {upward, upward_in};
+        const int root[] = {src, dst};
+        for (int side = 0; side < 2; side++) {
+            dist[side][root[side]] = 0;
+            query_touched[side]->add(root[side]);
+            heap[side]->insert(root[side], 0);
+        }
+        int best = INF, meet = -1;
+
+        while (true) {
+            // a side is done once it's empty or can't beat the best meeting point anymore
+            bool active[2];
+            for (int side = 0; side < 2; side++)
+                active[side] = !heap[side]->isEmpty() && heap[side]->keyOf(heap[side]->peekMin()) < best;
+            if (!active[0] && !active[1]) break;
+            const int side = !active[0] ? 1 : !active[1] ? 0 :
+                                                 heap[0]->keyOf(heap[0]->peekMin()) <= heap[1]->keyOf(heap[1]->peekMin()) ? 0 : 1;
+
+            const int u = heap[side]->popMin(), du = dist[side][u];
+            if (dist[1 - side][u] != INF && static_cast<long long>(du) + dist[1 - side][u] < best) {
+                best = du + dist[1 - side][u];
+                meet = u;
+            }
+            for (auto it = graph[side]->neighbours(u); !it.done(); it.next()) {
+                const int v = it.vertex();
+                if (const long long dv = static_cast<long long>(du) + it.weight(); dv < dist[side][v]) {
+                    if (dist[side][v] == INF) query_touched[side]->add(v);
+                    dist[side][v] = static_cast<int>(dv);
+                    parent[side][v] = u;
+                    heap[side]->push(v, dv);
+                }
+            }
+        }
+
+        if (meet != -1) {
+            // the (augmented) path: src-->meet by forward parents, meet-->dst by backward parents
+            ArrayList<int> packed;
+            for (int v = meet; v != -1; v = parent[0][v]) packed.add(v);
+            std::reverse(&packed[0], &packed[0] + packed.size());
+            for (int v = parent[1][meet]; v != -1; v = parent[1][v]) packed.add(v);
+
+            // unpack shortcuts, u->w becomes u->middle->w, recursively (explicit stack of edges)
+            ArrayList<int> &stack = *unpack_stack, &vertices = *unpacked;
+            vertices.add(packed[0]);
+            for (int i = 1; i < packed.size(); i++) {
+                stack.add(packed[i - 1]);
+                stack.add(packed[i]);
+                while (!stack.isEmpty()) {
+                    const int w = stack[stack.size() - 1], u = stack[stack.size() - 2];
+                    stack.pop();
+                    stack.pop();
+                    if (const auto m = middle->find(edgeKey(u, w))) {
+                        // push m->w below u->m, so u->m is unpacked first
+                        stack.add(*m);
+                        stack.add(w);
+                        stack.add(u);
+                        stack.add(*m);
+                    } else vertices.add(w);
+                }
+            }
+
+            path->dist = best;
+            path->length = vertices.size();
+            path->vertices = new int[vertices.size()];
+            std::copy(&vertices[0], &vertices[0] + vertices.size(), path->vertices);
+            vertices.clear();
+        }
+
+        // reset only what this query touched
+        for (int side = 0; side < 2; side++) {
+            for (int i = 0; i < query_touched[side]->size(); i++) {
+                const int v = (*query_touched[side])[i];
+                dist[side][v] = INF;
+                parent[side][v] = -1;
+            }
+            query_touched[side]->clear();
+            heap[side]->clear();
+        }
+        return path;
+    }
+
     /* Friendly Operators */
 
+    std::ostream &operator<<(std::ostream &os, const DFSForest &f) {
+        os << f.trees << "-tree dfs forest:\n";
+        // bucket nodes by tree (counting sort), so printing is O(n) however many trees there are
+        const auto at = new int[f.trees + 1](), by_tree = new int[f.n];
+        for (int v = 0; v < f.n; v++) at[f.tree[v] + 1]++;
+        for (int t = 0; t < f.trees; t++) at[t + 1] += at[t];
+        for (int v = 0; v < f.n; v++) by_tree[at[f.tree[v]]++] = v;
+
+        for (int t = 0, i = 0; t < f.trees; t++) {
+            os << "Tree [" << t << "]: ";
+            for (; i < f.n && f.tree[by_tree[i]] == t; i++) {
+                const int v = by_tree[i], p = f.parent[v];
+                if (p == -1) os << "(" << v << ")\t";
+                else os << p << ")-" << (f.directed ? "->" : "-") << "(" << v << "\t";
+            }
+            os << "\n";
+        }
+
+        delete[] at;
+        delete[] by_tree;
+        return os;
+    }
+
     std::ostream &operator<<(std::ostream &os, const Graph &g) {
         os <<
                 g.n << "-vtx, " <<
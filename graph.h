@@ -6,7 +6,9 @@
 #define GRAPH_H
 
 #include "data_structures.h"
+#include <algorithm>
 #include <climits>
+#include <cmath>
 
 using namespace ds;
 
@@ -41,6 +43,22 @@ namespace graphs {
             }
         };
 
+        // standalone (u, v, weight) edge, for edge list input
+        class WeightedEdge {
+        public:
+            int u, v, weight;
+
+            WeightedEdge(const int u, const int v, const int weight = 1) : u(u), v(v), weight(weight) {
+            }
+
+            WeightedEdge() : WeightedEdge(0, 0) {
+            }
+
+            bool operator<(const WeightedEdge &e) const {
+                return this->weight < e.weight;
+            }
+        };
+
         class VtxDist : public Edge {
         public:
             static constexpr int INF = INT_MAX;
@@ -65,7 +83,8 @@ namespace graphs {
 
             int dist() const { return weight; }
 
-            void relax(int d);
+            // d is a long long so callers can sum past INT_MAX, anything at or above INF never relaxes
+            bool relax(long long d);
 
             bool operator==(const VtxDist &c) const {
                 return this->src == c.src && Edge::operator==(c);
@@ -76,10 +95,36 @@ namespace graphs {
             }
         };
 
+        class NeighbourIterator {
+            const LinkedList<Edge>::Link<Edge> *link;
+
+        public:
+            explicit NeighbourIterator(const LinkedList<Edge>::Link<Edge> *head) : link(head) {
+            }
+
+            bool done() const { return link == nullptr; }
+
+            int vertex() const { return link->val.vertex; }
+
+            int weight() const { return link->val.weight; }
+
+            void next() { link = link->next; }
+        };
+
         const int n;
         LinkedList<Edge> *neighbour_list;
         const bool directed;
 
+    private:
+        // every adjacency list link of this graph is carved from this pool, and freed in bulk with it
+        SlabPool<LinkedList<Edge>::Link<Edge> > *links;
+        // optional (u,v) -> weight index, see buildEdgeIndex
+        HashIndex *edge_index = nullptr;
+
+        unsigned long long edgeKey(int u, int v) const;
+
+    public:
+
         Graph(int n, bool directed);
 
         explicit Graph(const int n) : Graph(n, false) {
@@ -90,8 +135,21 @@ namespace graphs {
         explicit Graph(const Graph *copy): Graph(copy, true) {
         }
 
+        /**
+         * Bulk build a graph from an edge list, in O(E + n).
+         * Edges are radix sorted on (u, v) and deduplicated in one pass, and adjacency is emitted directly,
+         * skipping addEdge's per edge checks. Results match calling addEdge on each edge in order
+         * (self loops and repeated edges are dropped, the first weight given for an edge is kept),
+         * except adjacency lists come out sorted by neighbour.
+         * Algorithms build their result graphs through it: addEdge's duplicate check rescans the growing
+         * adjacency list on every call, which turns quadratic on hubs (e.g. a shortest path tree's src).
+         */
+        static Graph *fromEdges(int n, bool directed, const WeightedEdge *edges, int count);
+
         ~Graph() {
             delete[] neighbour_list;
+            delete links;
+            delete edge_index;
         }
 
         int m() const;
@@ -104,48 +162,699 @@ namespace graphs {
 
         bool hasVtx(int u) const;
 
+        /**
+         * Index every edge by (u,v) in a hash map, kept up to date by addEdge and deleteEdge from now on.
+         * Makes hasEdge, weight(u,v) and addEdge's duplicate check O(1) expected instead of O(deg).
+         */
+        void buildEdgeIndex();
+
+        bool hasEdgeIndex() const { return edge_index != nullptr; }
+
         int weight(int u, int v) const;
 
         int weight() const;
 
         bool hasNegativeWeights() const;
 
+        int degree(const int u) const { return neighbour_list[u].length(); }
+
+        NeighbourIterator neighbours(const int u) const {
+            return NeighbourIterator(neighbour_list[u].head);
+        }
+
         void print_graph() const;
 
 
         friend std::ostream &operator<<(std::ostream &os, const Graph &g);
     };
 
+    /**
+     * Immutable Compressed Sparse Row snapshot of a Graph.
+     * The neighbours of u are targets[offsets[u]..offsets[u+1]) (with matching weights),
+     * stored contiguously and in the same order as u's adjacency list in the source graph.
+     */
+    class CSRGraph {
+    public:
+        class NeighbourIterator {
+            const int *target, *end, *w;
+
+        public:
+            NeighbourIterator(const int *target, const int *end, const int *w) : target(target), end(end), w(w) {
+            }
+
+            bool done() const { return target == end; }
+
+            int vertex() const { return *target; }
+
+            int weight() const { return *w; }
+
+            void next() { target++, w++; }
+        };
+
+        const int n;
+        const bool directed;
+        int *offsets; // n + 1 entries, offsets[n] is the number of stored (directed) edges
+        int *targets;
+        int *weights;
+
+        explicit CSRGraph(const Graph *graph);
+
+        // takes ownership of the given arrays
+        CSRGraph(int n, bool directed, int *offsets, int *targets, int *weights);
+
+        // graph with every edge reversed (for undirected graphs that's just a copy)
+        template<class G>
+        static CSRGraph *transpose(const G *graph);
+
+        ~CSRGraph() {
+            delete[] offsets;
+            delete[] targets;
+            delete[] weights;
+        }
+
+        int m() const;
+
+        int degree(const int u) const { return offsets[u + 1] - offsets[u]; }
+
+        bool hasVtx(int u) const;
+
+        int weight() const;
+
+        bool hasNegativeWeights() const;
+
+        NeighbourIterator neighbours(const int u) const {
+            return NeighbourIterator(targets + offsets[u], targets + offsets[u + 1], weights + offsets[u]);
+        }
+    };
+
+    /**
+     * A single src -> dst path: dist is its length (INF if dst isn't reachable),
+     * vertices[0..length) are its nodes in order, from src to dst (empty if unreachable).
+     */
+    class Path {
+    public:
+        const int src, dst;
+        int dist = Graph::VtxDist::INF;
+        int length = 0;
+        int *vertices = nullptr;
+
+        Path(const int src, const int dst) : src(src), dst(dst) {
+        }
+
+        ~Path() {
+            delete[] vertices;
+        }
+
+        bool found() const { return dist != Graph::VtxDist::INF; }
+    };
+
+    /**
+     * Single-source search result as flat arrays:
+     * parent[v] is v's predecessor on the path from src (-1 for src and unreached nodes),
+     * dist[v] is v's depth (bfs) or distance (weighted searches) from src, INF if unreached.
+     */
+    class PathTree {
+    public:
+        const int n, src;
+        int *parent;
+        int *dist;
+
+        PathTree(int n, int src);
+
+        ~PathTree() {
+            delete[] parent;
+            delete[] dist;
+        }
+
+        bool reached(const int v) const { return dist[v] != Graph::VtxDist::INF; }
+
+        // the tree path from src to v
+        Path *pathTo(int v) const;
+    };
+
+    /**
+     * DFS forest as flat arrays: parent[v] is v's dfs tree parent (-1 for tree roots),
+     * tree[v] is the id (0..trees-1, in visit order) of the tree v belongs to,
+     * discovery[v] / finish[v] are the times v was entered / left, from one clock running 0..2n-1.
+     * Costs O(n) no matter how many trees there are; Graphs are only built on demand by toGraph.
+     */
+    class DFSForest {
+    public:
+        const int n;
+        const bool directed;
+        int trees = 0;
+        int *parent;
+        int *tree;
+        int *discovery;
+        int *finish;
+
+        DFSForest(int n, bool directed);
+
+        ~DFSForest() {
+            delete[] parent;
+            delete[] tree;
+            delete[] discovery;
+            delete[] finish;
+        }
+
+        // the (n node) Graph of tree t's edges
+        Graph *toGraph(int t) const;
+
+        friend std::ostream &operator<<(std::ostream &os, const DFSForest &f);
+    };
+
+    /**
+     * Connected components labelling: id[v] is v's component (0..count-1, numbered by smallest node),
+     * size[c] is component c's node count. Directed graphs get their weakly connected components.
+     */
+    class Components {
+    public:
+        const int n;
+        int count = 0;
+        int *id;
+        int *size;
+
+        // labels components from any per node representative (e.g. a union set root)
+        Components(int n, const int *representative);
+
+        ~Components() {
+            delete[] id;
+            delete[] size;
+        }
+    };
+
+    /**
+     * A* heuristics: callables h(v, dst) giving a lower bound on the v-->dst distance.
+     * The coordinate ones hold (not own) per node x/y arrays, and are admissible as long as
+     * no edge weighs less than the distance between its ends.
+     */
+    class Heuristics {
+    public:
+        // h = 0, A* degenerates to djikstra
+        class Zero {
+        public:
+            int operator()(int, int) const { return 0; }
+        };
+
+        class Euclidean {
+            const double *x, *y;
+
+        public:
+            Euclidean(const double *x, const double *y) : x(x), y(y) {
+            }
+
+            int operator()(const int v, const int dst) const {
+                return static_cast<int>(std::floor(std::hypot(x[v] - x[dst], y[v] - y[dst])));
+            }
+        };
+
+        class Manhattan {
+            const double *x, *y;
+
+        public:
+            Manhattan(const double *x, const double *y) : x(x), y(y) {
+            }
+
+            int operator()(const int v, const int dst) const {
+                return static_cast<int>(std::floor(std::fabs(x[v] - x[dst]) + std::fabs(y[v] - y[dst])));
+            }
+        };
+    };
+
+    class Landmarks;
+
+    /**
+     * Every algorithm accepts either a Graph or a CSRGraph; both expose neighbours(u) iteration,
+     * so each algorithm has a single implementation templated on the graph representation.
+     * Results are always returned as (adjacency list) Graphs.
+     */
     class Algorithms {
-        static void dfs_recursive(const Graph *graph, int u, Graph *result, bool *visited);
+        friend class Landmarks;
+
+    public:
+        // djikstra's priority queue. Radix is a monotone radix heap over the (int, non-negative) distances.
+        enum class Heap { Binary, Radix };
+
+    private:
+
+        static int thread_count(int threads);
+
+        // runs work(i) for i in [0, threads), each on its own thread (the calling thread takes i = 0)
+        template<class F>
+        static void run_threads(int threads, const F &work);
+
+        // a node's (distance, parent) as one dist << 32 | parent word, so a single CAS settles both.
+        // dist may be negative, and reads back with an (arithmetic) >> 32.
+        static long long pack_dist(long long dist, int parent);
+
+        // the tree of n packed (distance, parent) words
+        static PathTree *unpack_dists(const std::atomic<long long> *state, int n, int src);
+
+        template<class G>
+        static DFSForest *dfs_forest_impl(const G *graph, int src);
+
+        template<class G>
+        static PathTree *bfs_tree_impl(const G *graph, int src);
+
+        template<class G>
+        static Graph *bfs_impl(const G *graph, int src);
+
+        template<class G, class R>
+        static PathTree *bfs_hybrid_impl(const G *graph, const R *incoming, int src, int alpha, int beta);
+
+        template<class G>
+        static PathTree *bfs_parallel_impl(const G *graph, int src, int threads);
+
+        template<class G>
+        static Graph **dfs_impl(const G *graph, int src);
+
+        template<class G>
+        static Components *components_impl(const G *graph);
+
+        template<class G>
+        static Components *components_parallel_impl(const G *graph, int threads);
+
+        template<class G>
+        static Components *scc_impl(const G *graph);
+
+        template<class G>
+        static Components *scc_parallel_impl(const G *graph, int threads);
+
+        template<class G>
+        static Graph *condensation_impl(const G *graph, const Components *scc);
+
+        template<class G, class Q = IndexedMinHeap>
+        static PathTree *djikstra_tree_impl(const G *graph, int src);
+
+        template<class G>
+        static PathTree *djikstra_tree_impl(const G *graph, int src, Heap heap);
+
+        template<class G>
+        static Graph *djikstra_impl(const G *graph, int src, Heap heap);
+
+        template<class G, class H>
+        static Path *astar_impl(const G *graph, int src, int dst, const H &heuristic);
+
+        template<class G>
+        static PathTree *delta_stepping_impl(const G *graph, int src, int delta, int threads);
+
+        template<class G>
+        static PathTree *bellman_ford_impl(const G *graph, int src);
+
+        template<class G>
+        static PathTree *bellman_ford_parallel_impl(const G *graph, int src, int threads);
+
+        template<class G>
+        static Graph *prim_impl(const G *graph, int src);
+
+        template<class G>
+        static Graph::WeightedEdge *undirected_edges(const G *graph, int &count);
+
+        template<class G>
+        static Graph *kruskal_impl(const G *graph);
+
+        // picks mst edges of [begin, end) into tree[m..], until n - 1 are picked
+        static void filter_kruskal(Graph::WeightedEdge *begin, Graph::WeightedEdge *end,
+                                   UnionSet &vertexes, int n, Graph::WeightedEdge *tree, int &m);
+
+        template<class G>
+        static Graph *filter_kruskal_impl(const G *graph);
+
+        template<class G>
+        static Graph *boruvka_impl(const G *graph, int threads);
 
     public:
         static Graph *bfs(const Graph *graph, int src);
 
+        static Graph *bfs(const CSRGraph &graph, int src);
+
+        static PathTree *bfsTree(const Graph *graph, int src);
+
+        static PathTree *bfsTree(const CSRGraph &graph, int src);
+
+        /**
+         * Direction-optimizing BFS (Beamer et al.): expands the frontier top-down while it's small,
+         * and switches to bottom-up steps (every unreached node looks for a parent in the frontier)
+         * once the frontier's edges outnumber the unexplored edges / alpha,
+         * switching back once the frontier shrinks below n / beta.
+         * Produces the same depths as bfsTree; parents are valid bfs parents but may be
+         * a different (equally shallow) neighbour than the one top-down bfs picks.
+         */
+        static PathTree *bfsHybrid(const Graph *graph, int src, int alpha = 15, int beta = 18);
+
+        static PathTree *bfsHybrid(const CSRGraph &graph, int src, int alpha = 15, int beta = 18);
+
+        /**
+         * Level-synchronous multithreaded BFS. Threads split each frontier level between them,
+         * claim nodes with compare-and-swap on the parent array, and gather the next level in thread local buffers.
+         * threads = 0 uses all hardware threads.
+         * Produces the same depths as bfsTree; parents are valid bfs parents but which of the equally shallow
+         * candidates wins depends on thread timing.
+         */
+        static PathTree *bfsParallel(const Graph *graph, int src, int threads = 0);
+
+        static PathTree *bfsParallel(const CSRGraph &graph, int src, int threads = 0);
+
         static Graph **dfs(const Graph *graph, int);
 
-        static Graph *djikstra(const Graph *graph, int src);
+        static Graph **dfs(const CSRGraph &graph, int);
+
+        /**
+         * Iterative DFS (explicit heap stack of (node, neighbour iterator) frames, no recursion),
+         * visiting trees from src and then from every unvisited node after it, wrapping around.
+         */
+        static DFSForest *dfsForest(const Graph *graph, int src);
+
+        static DFSForest *dfsForest(const CSRGraph &graph, int src);
+
+        // sequential union find (UnionSet) over all edges
+        static Components *connectedComponents(const Graph *graph);
+
+        static Components *connectedComponents(const CSRGraph &graph);
+
+        /**
+         * Afforest style parallel components over a ConcurrentUnionSet: threads first union every node with
+         * its first couple of neighbours, then sample the (likely giant) biggest component,
+         * and only go over the remaining edges of nodes outside of it. threads = 0 uses all hardware threads.
+         */
+        static Components *connectedComponentsParallel(const Graph *graph, int threads = 0);
+
+        static Components *connectedComponentsParallel(const CSRGraph &graph, int threads = 0);
+
+        // iterative Tarjan, O(n + m) with no recursion. (on undirected graphs, same as connectedComponents)
+        static Components *stronglyConnectedComponents(const Graph *graph);
+
+        static Components *stronglyConnectedComponents(const CSRGraph &graph);
+
+        /**
+         * Parallel strongly connected components: peels off every node with no incoming or no outgoing edges
+         * left (singleton components), takes out the pivot's component (usually the giant one) by one forward and
+         * one backward search from the node with most in * out degree, then repeats coloring over the rest:
+         * threads propagate the max node id forward, and every node that kept its own id as color collects its
+         * component by a backward search within its color. Every search only walks a worklist of the nodes that
+         * changed, on one team of threads, and trimming reruns after every pass.
+         * threads = 0 uses all hardware threads.
+         */
+        static Components *stronglyConnectedComponentsParallel(const Graph *graph, int threads = 0);
+
+        static Components *stronglyConnectedComponentsParallel(const CSRGraph &graph, int threads = 0);
+
+        // DAG of the components (scc->count nodes), with an edge c1->c2 for the first edge found between them
+        static Graph *condensation(const Graph *graph, const Components *scc);
+
+        static Graph *condensation(const CSRGraph &graph, const Components *scc);
+
+        static Graph *djikstra(const Graph *graph, int src, Heap heap = Heap::Binary);
+
+        static Graph *djikstra(const CSRGraph &graph, int src, Heap heap = Heap::Binary);
+
+        // djikstra's shortest distances and shortest path tree parents, as flat arrays
+        static PathTree *djikstraTree(const Graph *graph, int src, Heap heap = Heap::Binary);
+
+        static PathTree *djikstraTree(const CSRGraph &graph, int src, Heap heap = Heap::Binary);
+
+        /**
+         * Point to point shortest path: djikstra from src forward and from dst backward (along reversed edges),
+         * always advancing the side with the closer frontier, and stopping once the frontiers' distances sum up to
+         * the best src-->dst path already seen through a node reached by both.
+         * A one off query, it pays for a BidirectionalDjikstra engine; keep one for repeated queries.
+         */
+        static Path *bidirectionalDjikstra(const Graph *graph, int src, int dst);
+
+        static Path *bidirectionalDjikstra(const CSRGraph &graph, int src, int dst);
+
+        /**
+         * A* src -> dst: djikstra's relaxation, but nodes are popped by distance + heuristic(v, dst),
+         * and the search stops as soon as dst is popped. heuristic is any callable (see Heuristics),
+         * taken as a template parameter so it inlines. It must never overestimate;
+         * if it's not also consistent, nodes may be reopened, which stays correct.
+         */
+        template<class H>
+        static Path *astar(const Graph *graph, int src, int dst, const H &heuristic);
+
+        template<class H>
+        static Path *astar(const CSRGraph &graph, int src, int dst, const H &heuristic);
+
+        /**
+         * Delta-stepping parallel single source shortest paths (Meyer & Sanders), same distances as djikstra.
+         * Nodes are kept in buckets of width delta by tentative distance. The lowest bucket is emptied by relaxing its
+         * light (weight <= delta) edges in parallel until it stops refilling, then its nodes' heavy edges are relaxed
+         * in parallel once. Relaxation is a CAS-min on a packed (distance, parent) word, and each thread queues the
+         * nodes it improved in its own buckets. One team of threads runs all the phases.
+         * delta = 0 picks max weight / average degree, and delta is raised to at least max weight / 1022 to bound
+         * the (cyclic) bucket count. threads = 0 uses all hardware threads.
+         */
+        static PathTree *deltaStepping(const Graph *graph, int src, int delta = 0, int threads = 0);
+
+        static PathTree *deltaStepping(const CSRGraph &graph, int src, int delta = 0, int threads = 0);
+
+        /**
+         * Shortest paths allowing negative weights: queue based Bellman-Ford (SPFA). Only nodes whose distance
+         * improved are queued to relax their edges again.
+         * Throws std::domain_error if a negative cycle is reachable from src (on an undirected graph,
+         * any reachable negative edge is one). Paths weighing INF or more are left unreached.
+         */
+        static PathTree *bellmanFord(const Graph *graph, int src);
+
+        static PathTree *bellmanFord(const CSRGraph &graph, int src);
+
+        /**
+         * Round based parallel Bellman-Ford: each round, threads split the nodes improved since the last round and
+         * relax their edges with a CAS-min on a packed (distance, parent) word, so a round costs only their edges
+         * (rounds smaller than a chunk run on one thread). All rounds share one team of threads. Without negative
+         * cycles it settles within n - 1 rounds, so a node still improving after that throws std::domain_error.
+         * threads = 0 uses all hardware threads.
+         */
+        static PathTree *bellmanFordParallel(const Graph *graph, int src, int threads = 0);
+
+        static PathTree *bellmanFordParallel(const CSRGraph &graph, int src, int threads = 0);
 
         static Graph *prim(const Graph *graph, int src);
 
+        static Graph *prim(const CSRGraph &graph, int src);
+
         static Graph *kruskal(const Graph *graph);
+
+        static Graph *kruskal(const CSRGraph &graph);
+
+        /**
+         * Filter-Kruskal: partitions edges around a pivot weight (quicksort style), recurses on the light part first,
+         * then drops heavy edges whose endpoints the light part already joined before recursing on the rest.
+         * Same result as kruskal, but on E >> V graphs most heavy edges are filtered instead of sorted.
+         */
+        static Graph *filterKruskal(const Graph *graph);
+
+        static Graph *filterKruskal(const CSRGraph &graph);
+
+        /**
+         * Parallel Boruvka MST (spanning forest for disconnected graphs, like kruskal).
+         * Every round, threads split the edges and find each component's lightest outgoing edge
+         * (atomic min on weight, ties broken by edge index), then all those edges are merged through a ConcurrentUnionSet.
+         * At most log(n) rounds. threads = 0 uses all hardware threads.
+         */
+        static Graph *boruvka(const Graph *graph, int threads = 0);
+
+        static Graph *boruvka(const CSRGraph &graph, int threads = 0);
+    };
+
+    /**
+     * Bidirectional djikstra (see Algorithms::bidirectionalDjikstra) for many point to point queries on one graph.
+     * The reversed graph a directed search needs is built once (or handed in), and queries reuse scratch buffers,
+     * resetting only the nodes they touched, so a query costs only what it searches. As a consequence one engine
+     * can't be queried from several threads at once.
+     */
+    class BidirectionalDjikstra {
+        const CSRGraph *outgoing, *incoming;
+        bool owns_outgoing = false, owns_incoming = false;
+
+        // query scratch, all dist INF, parents -1 and nothing settled between queries
+        int *dist[2], *parent[2];
+        IndexedMinHeap *heap[2];
+        Bitmap *settled[2];
+        ArrayList<int> *touched[2];
+
+        void allocate();
+
+    public:
+        const int n;
+
+        // snapshots graph as a CSRGraph
+        explicit BidirectionalDjikstra(const Graph *graph);
+
+        // graph (and incoming) must outlive the engine. incoming is graph's transpose, built here if not given.
+        explicit BidirectionalDjikstra(const CSRGraph &graph, const CSRGraph *incoming = nullptr);
+
+        ~BidirectionalDjikstra();
+
+        Path *query(int src, int dst) const;
+    };
+
+    /**
+     * ALT (A*, Landmarks, Triangle inequality) distance oracle for a static graph.
+     * Preprocessing picks k landmarks spread far apart, and runs djikstra from each (and, on directed graphs,
+     * also along reversed edges, for distances *to* each landmark), storing k x n distance tables.
+     * The triangle inequality then bounds any distance from both sides in O(k):
+     *      d(v,t) >= d(L,t) - d(L,v)  and  d(v,t) >= d(v,L) - d(t,L)
+     *      d(v,t) <= d(v,L) + d(L,t)
+     * Landmarks is itself an A* heuristic, h(v, t) = lowerBound(v, t).
+     */
+    class Landmarks {
+        template<class G>
+        void preprocess(const G *graph);
+
+    public:
+        const int n, k;
+        const bool directed;
+        int *landmarks;
+        int *from; // from[i * n + v] = d(landmarks[i], v)
+        int *to;   // to[i * n + v] = d(v, landmarks[i]). same table as from for undirected graphs
+
+        Landmarks(const Graph *graph, int k);
+
+        Landmarks(const CSRGraph &graph, int k);
+
+        ~Landmarks() {
+            delete[] landmarks;
+            if (to != from) delete[] to;
+            delete[] from;
+        }
+
+        int lowerBound(int v, int t) const;
+
+        // estimate from above, INF when no landmark connects v to t
+        int upperBound(int v, int t) const;
+
+        int operator()(const int v, const int t) const { return lowerBound(v, t); }
+    };
+
+    /**
+     * Contraction Hierarchies for point to point queries on a static graph with non-negative weights.
+     * Preprocessing contracts nodes one at a time in order of importance (2 * edge difference + contracted
+     * neighbours, recomputed lazily once a neighbour was contracted): contracting v adds a shortcut u->w for every
+     * u->v->w lighter than the current u->w edge with no witness path around v that's as short. One bounded local
+     * djikstra from each u serves all of its w (importance only estimates it, with a smaller bound).
+     * Contracted nodes leave the working graph, whose edges are looked up in a hash map,
+     * and every node's remaining edges at its contraction are its upward edges.
+     * A query is a bidirectional djikstra where both sides only climb to higher ranked nodes,
+     * and shortcuts on the found path are unpacked back into original edges.
+     * Queries reuse scratch buffers, resetting only the nodes they touched, so one engine can't be queried from
+     * several threads at once.
+     */
+    class ContractionHierarchy {
+        static constexpr int WITNESS_SETTLE_LIMIT = 500, SIMULATE_SETTLE_LIMIT = 50;
+
+        // query scratch, all dist INF and parents -1 between queries
+        int *query_dist[2], *query_parent[2];
+        IndexedMinHeap *query_heap[2];
+        ArrayList<int> *query_touched[2], *unpack_stack, *unpacked;
+
+        template<class G>
+        void preprocess(const G *graph);
+
+        unsigned long long edgeKey(int u, int w) const;
+
+    public:
+        const int n;
+        const bool directed;
+        int *rank;             // contraction order of every node
+        Graph *augmented;      // input graph + shortcuts (a shortcut replaces a heavier direct edge)
+        int shortcuts = 0;
+        CSRGraph *upward;      // augmented edges u->w with rank[w] > rank[u]
+        CSRGraph *upward_in;   // augmented edges u->w with rank[u] > rank[w], stored reversed (w->u). upward if undirected
+        HashIndex *middle;     // shortcut (u,w) -> node v it bypasses
+
+        explicit ContractionHierarchy(const Graph *graph);
+
+        explicit ContractionHierarchy(const CSRGraph &graph);
+
+        ~ContractionHierarchy() {
+            delete[] rank;
+            delete augmented;
+            if (upward_in != upward) delete upward_in;
+            delete upward;
+            delete middle;
+            for (int side = 0; side < 2; side++) {
+                delete[] query_dist[side];
+                delete[] query_parent[side];
+                delete query_heap[side];
+                delete query_touched[side];
+            }
+            delete unpack_stack;
+            delete unpacked;
+        }
+
+        Path *query(int src, int dst) const;
     };
 
     std::ostream &operator<<(std::ostream &os, const Graph &g);
 
-    static void assert_graph(const Graph *graph) {
+    std::ostream &operator<<(std::ostream &os, const DFSForest &f);
+
+    template<class G>
+    static void assert_graph(const G *graph) {
         if (graph == nullptr) throw std::invalid_argument("graph can't be null");
         if (graph->n == 0) throw std::invalid_argument("graph is empty");
     }
 
-    static void assert_graph_vtx(const Graph *graph, const int v) {
+    template<class G>
+    static void assert_graph_vtx(const G *graph, const int v) {
         if (!graph->hasVtx(v)) throw std::invalid_argument("node " + std::to_string(v) + " doesn't exist");
     }
 
-    static void assert_graph_non_negative(const Graph *graph) {
+    template<class G>
+    static void assert_graph_non_negative(const G *graph) {
         if (graph->hasNegativeWeights())
             throw std::invalid_argument("negative weights are not supported");
     }
+
+    /* A* (templated on the heuristic, so defined here) */
+
+    template<class G, class H>
+    Path *Algorithms::astar_impl(const G *graph, const int src, const int dst, const H &heuristic) {
+        assert_graph(graph);
+        assert_graph_vtx(graph, src);
+        assert_graph_vtx(graph, dst);
+        assert_graph_non_negative(graph);
+
+        // each node's shortest distance *so far* from src
+        const auto s_dist = new Graph::VtxDist[graph->n];
+        for (int i = 0; i < graph->n; i++) s_dist[i] = Graph::VtxDist(src, i);
+        s_dist[src].relax(0);
+        PathTree tree(graph->n, src);
+        tree.dist[src] = 0;
+
+        // open nodes, keyed by distance + estimate of what's left to dst
+        IndexedMinHeap open(graph->n);
+        open.insert(src, heuristic(src, dst));
+        while (!open.isEmpty()) {
+            const int u = open.popMin(), su_d = s_dist[u].dist();
+            if (u == dst) break;
+
+            for (auto n = graph->neighbours(u); !n.done(); n.next()) {
+                const int v = n.vertex();
+                if (s_dist[v].relax(static_cast<long long>(su_d) + n.weight())) {
+                    tree.dist[v] = s_dist[v].dist();
+                    tree.parent[v] = u;
+                    // keys past INT_MAX all sort last
+                    const long long key = static_cast<long long>(tree.dist[v]) + heuristic(v, dst);
+                    open.push(v, static_cast<int>(std::min<long long>(key, INT_MAX)));
+                }
+            }
+        }
+
+        delete[] s_dist;
+        return tree.pathTo(dst);
+    }
+
+    template<class H>
+    Path *Algorithms::astar(const Graph *graph, const int src, const int dst, const H &heuristic) {
+        return astar_impl(graph, src, dst, heuristic);
+    }
+
+    template<class H>
+    Path *Algorithms::astar(const CSRGraph &graph, const int src, const int dst, const H &heuristic) {
+        return astar_impl(&graph, src, dst, heuristic);
+    }
 } // graphs
 
 
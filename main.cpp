@@ -37,14 +37,9 @@ void algorithm_ui(const Graph *g) {
                     break;
                 }
                 case 2: {
-                    const auto forest = Algorithms::dfs(g, 0);
-                    for (int i = 0; i < g->n && forest[i]; ++i) {
-                        std::cout << "Tree [" << i << "]:\n";
-                        forest[i]->print_graph();
-                    }
-                    for (int v = 0; v<g->n; v++)
-                        delete forest[v];
-                    delete[] forest;
+                    const auto forest = Algorithms::dfsForest(g, 0);
+                    std::cout << *forest;
+                    delete forest;
                     break;
                 }
                 case 3: {